@@ -0,0 +1,65 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "BenchLua.h"
+
+// C++ heap bytes requested by the process; string copies made while crossing the Lua/C++ boundary show up here.
+// Replacing operator new affects every benchmark linked with it, so this file is built as a separate executable
+// (aui.bindings.lua.bench.heap)
+static std::atomic<std::size_t> gHeapBytes{0};
+
+void* operator new(std::size_t size) {
+    gHeapBytes.fetch_add(size, std::memory_order_relaxed);
+    if (auto p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+/**
+ * @brief Text update of a chat or log line from Lua, reporting C++ heap bytes and Lua allocations per update.
+ * @param view expression creating the view.
+ * @param call statement using `v` and the line `s`.
+ */
+static void BM_TextUpdate(benchmark::State& state, std::string view, std::string call) {
+    BenchLua b;
+    auto run = b.lua.do_string<clg::function>(
+        "local v = " + view + "\n"
+        "local s = string.rep('chat message with some text, ', 8)\n"
+        "return function(n) for i = 1, n do " + call + " end end");
+    constexpr int CALLS_PER_ITERATION = 100;
+    std::size_t bytes = 0;
+    LuaAllocationCounter luaAllocations(b.state());
+    for (auto _ : state) {
+        auto before = gHeapBytes.load(std::memory_order_relaxed);
+        run(CALLS_PER_ITERATION);
+        bytes += gHeapBytes.load(std::memory_order_relaxed) - before;
+    }
+    auto updates = double(state.iterations() * CALLS_PER_ITERATION);
+    state.SetItemsProcessed(state.iterations() * CALLS_PER_ITERATION);
+    state.counters["heapBytesPerUpdate"] = benchmark::Counter(double(bytes) / updates);
+    state.counters["luaAllocationsPerUpdate"] = benchmark::Counter(double(luaAllocations.allocations()) / updates);
+}
+
+BENCHMARK_CAPTURE(BM_TextUpdate, Label_setText, std::string("Label('')"), std::string("v:setText(s)"));
+BENCHMARK_CAPTURE(BM_TextUpdate, Button_ctor, std::string("nil"), std::string("Button(s)"));
+BENCHMARK_CAPTURE(BM_TextUpdate, Input_text, std::string("Input(string.rep('log line ', 20))"), std::string("v:text()"));
@@ -0,0 +1,73 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#pragma once
+
+#include <clg.hpp>
+#include <AUI/View/AViewContainer.h>
+#include <uiengine/UIEngine.h>
+
+/**
+ * @brief Lua VM with UIEngine bindings registered, same setup as UIStylesTest.
+ */
+struct BenchLua {
+    clg::vm lua;
+    AViewContainer surface;
+    UIEngine uiEngine{surface};
+
+    lua_State* state() {
+        return lua;
+    }
+
+    /**
+     * @brief Lua heap size in bytes after a full collection.
+     */
+    std::size_t heapBytes() {
+        lua_gc(state(), LUA_GCCOLLECT, 0);
+        return std::size_t(lua_gc(state(), LUA_GCCOUNT, 0)) * 1024 + std::size_t(lua_gc(state(), LUA_GCCOUNTB, 0));
+    }
+};
+
+/**
+ * @brief Counts Lua heap allocations (new blocks and growing reallocations) of a state while alive.
+ */
+class LuaAllocationCounter {
+public:
+    explicit LuaAllocationCounter(lua_State* l): mState(l) {
+        mWrapped = lua_getallocf(l, &mWrappedUd);
+        lua_setallocf(l, alloc, this);
+    }
+
+    ~LuaAllocationCounter() {
+        lua_setallocf(mState, mWrapped, mWrappedUd);
+    }
+
+    LuaAllocationCounter(const LuaAllocationCounter&) = delete;
+    LuaAllocationCounter& operator=(const LuaAllocationCounter&) = delete;
+
+    [[nodiscard]]
+    std::size_t allocations() const noexcept {
+        return mAllocations;
+    }
+
+private:
+    lua_State* mState;
+    lua_Alloc mWrapped;
+    void* mWrappedUd = nullptr;
+    std::size_t mAllocations = 0;
+
+    static void* alloc(void* ud, void* ptr, std::size_t osize, std::size_t nsize) {
+        auto self = static_cast<LuaAllocationCounter*>(ud);
+        if (nsize != 0 && (ptr == nullptr || nsize > osize)) {
+            ++self->mAllocations;
+        }
+        return self->mWrapped(self->mWrappedUd, ptr, osize, nsize);
+    }
+};
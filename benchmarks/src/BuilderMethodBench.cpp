@@ -0,0 +1,40 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include <benchmark/benchmark.h>
+#include "BenchLua.h"
+
+/**
+ * @brief Lua -> C++ method call on an existing view, called from a Lua loop so the call itself dominates.
+ * @param view expression creating the view.
+ * @param call method call on `v`.
+ */
+static void BM_MethodCall(benchmark::State& state, std::string view, std::string call) {
+    BenchLua b;
+    auto run = b.lua.do_string<clg::function>("local v = " + view + "\n"
+                                              "return function(n) for i = 1, n do " + call + " end end");
+    constexpr int CALLS_PER_ITERATION = 100;
+    for (auto _ : state) {
+        run(CALLS_PER_ITERATION);
+    }
+    state.SetItemsProcessed(state.iterations() * CALLS_PER_ITERATION);
+}
+
+// AView class methods (ExposeHelper)
+BENCHMARK_CAPTURE(BM_MethodCall, View_setEnabled, std::string("View()"), std::string("v:setEnabled(true)"));
+BENCHMARK_CAPTURE(BM_MethodCall, View_getSize, std::string("View()"), std::string("v:getSize()"));
+BENCHMARK_CAPTURE(BM_MethodCall, View_addStylesheetName, std::string("View()"), std::string("v:addStylesheetName('a')"));
+
+// ViewExposer::builder / ViewExposer::method
+BENCHMARK_CAPTURE(BM_MethodCall, Input_setPasswordMode, std::string("Input('')"), std::string("v:setPasswordMode(false)"));
+BENCHMARK_CAPTURE(BM_MethodCall, Progressbar_setValue, std::string("Progressbar()"), std::string("v:setValue(0.5)"));
+BENCHMARK_CAPTURE(BM_MethodCall, Progressbar_value, std::string("Progressbar()"), std::string("v:value()"));
+BENCHMARK_CAPTURE(BM_MethodCall, Checkbox_setChecked, std::string("Checkbox()"), std::string("v:setChecked(true)"));
+BENCHMARK_CAPTURE(BM_MethodCall, Label_setText, std::string("Label('')"), std::string("v:setText('hello')"));
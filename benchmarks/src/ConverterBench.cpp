@@ -0,0 +1,193 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include <benchmark/benchmark.h>
+#include "BenchLua.h"
+#include "MyButton.h"
+#include <AUI/View/ALabel.h>
+#include "lauxlib.h"
+
+/**
+ * @brief clg::converter<T>::to_lua from Converters.h.
+ */
+template<typename T>
+static void BM_ToLua(benchmark::State& state, T value) {
+    BenchLua b;
+    auto L = b.state();
+    for (auto _ : state) {
+        clg::push_to_lua(L, value);
+        lua_settop(L, 0);
+    }
+}
+
+/**
+ * @brief clg::converter<T>::from_lua from Converters.h.
+ * @param expression Lua expression producing the value to convert.
+ */
+template<typename T>
+static void BM_FromLua(benchmark::State& state, std::string expression) {
+    BenchLua b;
+    auto L = b.state();
+    if (luaL_dostring(L, ("return " + expression).c_str()) != 0) {
+        state.SkipWithError(lua_tostring(L, -1));
+        return;
+    }
+    for (auto _ : state) {
+        auto result = clg::get_from_lua_raw<T>(L, -1);
+        if (result.is_error()) {
+            state.SkipWithError("conversion failed");
+            break;
+        }
+        benchmark::DoNotOptimize(result);
+    }
+    lua_settop(L, 0);
+}
+
+static APointerPressedEvent pointerPressedEvent() {
+    APointerPressedEvent e;
+    e.position = { 10.f, 20.f };
+    e.pointerIndex = APointerIndex::button(AInput::LBUTTON);
+    e.asButton = AInput::LBUTTON;
+    return e;
+}
+
+static APointerReleasedEvent pointerReleasedEvent() {
+    APointerReleasedEvent e;
+    e.position = { 10.f, 20.f };
+    e.pointerIndex = APointerIndex::button(AInput::LBUTTON);
+    e.asButton = AInput::LBUTTON;
+    e.triggerClick = true;
+    return e;
+}
+
+static APointerMoveEvent pointerMoveEvent() {
+    APointerMoveEvent e;
+    e.pointerIndex = APointerIndex::finger(0);
+    return e;
+}
+
+static AScrollEvent scrollEvent() {
+    AScrollEvent e;
+    e.origin = { 10.f, 20.f };
+    e.delta = { 0.f, 120.f };
+    e.kinetic = false;
+    e.pointerIndex = APointerIndex::button(AInput::LBUTTON);
+    return e;
+}
+
+BENCHMARK_CAPTURE(BM_ToLua<AString>, AString, AString("Hello, world! Lorem ipsum dolor sit amet"));
+BENCHMARK_CAPTURE(BM_FromLua<AString>, AString, std::string("'Hello, world! Lorem ipsum dolor sit amet'"));
+BENCHMARK_CAPTURE(BM_ToLua<APath>, APath, APath("assets/img/icon.svg"));
+BENCHMARK_CAPTURE(BM_FromLua<APath>, APath, std::string("'assets/img/icon.svg'"));
+BENCHMARK_CAPTURE(BM_ToLua<AChar>, AChar, AChar(U'ж'));
+BENCHMARK_CAPTURE(BM_FromLua<AChar>, AChar, std::string("1078"));
+BENCHMARK_CAPTURE(BM_ToLua<AMetric>, AMetric, AMetric(16, AMetric::T_DP));
+BENCHMARK_CAPTURE(BM_FromLua<AMetric>, AMetric, std::string("16"));
+BENCHMARK_CAPTURE(BM_ToLua<APointerIndex>, APointerIndex, APointerIndex::finger(1));
+BENCHMARK_CAPTURE(BM_ToLua<APointerMoveEvent>, APointerMoveEvent, pointerMoveEvent());
+BENCHMARK_CAPTURE(BM_ToLua<APointerPressedEvent>, APointerPressedEvent, pointerPressedEvent());
+BENCHMARK_CAPTURE(BM_ToLua<APointerReleasedEvent>, APointerReleasedEvent, pointerReleasedEvent());
+BENCHMARK_CAPTURE(BM_ToLua<ALongPressEvent>, ALongPressEvent, ALongPressEvent{});
+BENCHMARK_CAPTURE(BM_ToLua<AScrollEvent>, AScrollEvent, scrollEvent());
+BENCHMARK_CAPTURE(BM_ToLua<AStringVector>, AStringVector, AStringVector{"one", "two", "three", "four"});
+BENCHMARK_CAPTURE(BM_FromLua<AStringVector>, AStringVector, std::string("{'one', 'two', 'three', 'four'}"));
+BENCHMARK_CAPTURE(BM_ToLua<glm::vec2>, vec2, glm::vec2(1.f, 2.f));
+BENCHMARK_CAPTURE(BM_FromLua<glm::vec2>, vec2, std::string("{1, 2}"));
+BENCHMARK_CAPTURE(BM_FromLua<glm::vec2>, vec2_userdata, std::string("vec2(1, 2)"));
+BENCHMARK_CAPTURE(BM_ToLua<glm::ivec2>, ivec2, glm::ivec2(1, 2));
+BENCHMARK_CAPTURE(BM_FromLua<glm::ivec2>, ivec2, std::string("{1, 2}"));
+BENCHMARK_CAPTURE(BM_FromLua<glm::ivec2>, ivec2_userdata, std::string("vec2(1, 2)"));
+BENCHMARK_CAPTURE(BM_ToLua<glm::vec3>, vec3, glm::vec3(1.f, 2.f, 3.f));
+BENCHMARK_CAPTURE(BM_FromLua<glm::vec3>, vec3, std::string("{1, 2, 3}"));
+BENCHMARK_CAPTURE(BM_ToLua<glm::vec4>, vec4, glm::vec4(1.f, 2.f, 3.f, 4.f));
+BENCHMARK_CAPTURE(BM_FromLua<glm::vec4>, vec4, std::string("{1, 2, 3, 4}"));
+BENCHMARK_CAPTURE(BM_ToLua<AColor>, AColor, AColor::RED);
+BENCHMARK_CAPTURE(BM_FromLua<AColor>, AColor_string, std::string("'#ff0000'"));
+BENCHMARK_CAPTURE(BM_FromLua<AColor>, AColor_vec4, std::string("{255, 0, 0, 255}"));
+BENCHMARK_CAPTURE(BM_ToLua<AAngleRadians>, AAngleRadians, 90_deg);
+BENCHMARK_CAPTURE(BM_FromLua<AAngleRadians>, AAngleRadians, std::string("90"));
+BENCHMARK_CAPTURE(BM_ToLua<ass::unset_wrap<float>>, unset_wrap, ass::unset_wrap<float>(1.f));
+BENCHMARK_CAPTURE(BM_FromLua<ass::unset_wrap<float>>, unset_wrap_set, std::string("1"));
+BENCHMARK_CAPTURE(BM_FromLua<ass::unset_wrap<float>>, unset_wrap_unset, std::string("{}"));
+BENCHMARK_CAPTURE(BM_ToLua<std::optional<float>>, optional, std::optional<float>(1.f));
+BENCHMARK_CAPTURE(BM_FromLua<std::optional<float>>, optional, std::string("1"));
+BENCHMARK_CAPTURE(BM_ToLua<A2DTransform>, A2DTransform, A2DTransform{});
+BENCHMARK_CAPTURE(BM_ToLua<aui::float_within_0_1>, ranged_number, aui::float_within_0_1(0.5f));
+BENCHMARK_CAPTURE(BM_FromLua<aui::float_within_0_1>, ranged_number, std::string("0.5"));
+
+/**
+ * @brief converter_shared_ptr for views: push of a view that already has a Lua counterpart.
+ */
+static void BM_ToLuaView(benchmark::State& state) {
+    BenchLua b;
+    auto L = b.state();
+    auto view = b.lua.do_string<_<AView>>("return View()");
+    for (auto _ : state) {
+        clg::push_to_lua(L, view);
+        lua_settop(L, 0);
+    }
+}
+BENCHMARK(BM_ToLuaView);
+
+static void BM_FromLuaView(benchmark::State& state) {
+    BenchLua b;
+    auto L = b.state();
+    if (luaL_dostring(L, "return Button('test')") != 0) {
+        state.SkipWithError(lua_tostring(L, -1));
+        return;
+    }
+    for (auto _ : state) {
+        auto result = clg::get_from_lua_raw<_<MyButton>>(L, -1);
+        benchmark::DoNotOptimize(result);
+    }
+    lua_settop(L, 0);
+}
+BENCHMARK(BM_FromLuaView);
+
+/**
+ * @brief ILuaExposedView::fromView, the lookup behind view pushes, container casts and signal connections.
+ * @param luaView whether the view is made by Lua (found) or is a plain AUI view (not found).
+ */
+static void BM_FromView(benchmark::State& state, bool luaView) {
+    BenchLua b;
+    auto view = luaView ? b.lua.do_string<_<AView>>("return Button('test')") : _new<ALabel>("test");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ILuaExposedView::fromView(view.get()));
+    }
+}
+BENCHMARK_CAPTURE(BM_FromView, lua_view, true);
+BENCHMARK_CAPTURE(BM_FromView, plain_view, false);
+
+/**
+ * @brief What fromView replaces: dynamic_cast from AView across to the sibling ILuaExposedView base.
+ */
+static void BM_FromViewDynamicCast(benchmark::State& state) {
+    BenchLua b;
+    auto view = b.lua.do_string<_<AView>>("return Button('test')");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dynamic_cast<ILuaExposedView*>(view.get()));
+    }
+}
+BENCHMARK(BM_FromViewDynamicCast);
+
+static void BM_FromLuaViewAsBase(benchmark::State& state) {
+    BenchLua b;
+    auto L = b.state();
+    if (luaL_dostring(L, "return Button('test')") != 0) {
+        state.SkipWithError(lua_tostring(L, -1));
+        return;
+    }
+    for (auto _ : state) {
+        auto result = clg::get_from_lua_raw<_<AView>>(L, -1);
+        benchmark::DoNotOptimize(result);
+    }
+    lua_settop(L, 0);
+}
+BENCHMARK(BM_FromLuaViewAsBase);
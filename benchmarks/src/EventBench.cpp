@@ -0,0 +1,95 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include <benchmark/benchmark.h>
+#include "BenchLua.h"
+
+/**
+ * @brief Delivery of input events to a Lua override of a view.
+ * @details
+ * lua_allocs_per_event counts Lua heap allocations per delivered event; state.range(0) selects whether the handler
+ * reads the event fields (1) or ignores them (0).
+ */
+template<typename Event, typename Deliver>
+static void deliverEvents(benchmark::State& state, const std::string& overrideName, const std::string& fieldsRead,
+                          Event event, Deliver&& deliver) {
+    BenchLua b;
+    auto body = state.range(0) ? "local _ = " + fieldsRead : std::string{};
+    auto view = b.lua.do_string<_<AView>>(R"(
+local v = View()
+function v:)" + overrideName + R"((event)
+  )" + body + R"(
+end
+return v
+)");
+    deliver(*view, event); // creates the reusable event objects, if any
+    lua_gc(b.state(), LUA_GCCOLLECT, 0);
+
+    LuaAllocationCounter counter(b.state());
+    for (auto _ : state) {
+        deliver(*view, event);
+    }
+    state.counters["lua_allocs_per_event"] = double(counter.allocations()) / double(state.iterations());
+}
+
+static void BM_PointerPressedDelivery(benchmark::State& state) {
+    APointerPressedEvent e;
+    e.position = { 10.f, 20.f };
+    e.pointerIndex = APointerIndex::button(AInput::LBUTTON);
+    e.asButton = AInput::LBUTTON;
+    deliverEvents(state, "onPointerPressed", "event.button, event.finger", e, [](AView& v, const auto& e) {
+        v.onPointerPressed(e);
+    });
+}
+BENCHMARK(BM_PointerPressedDelivery)->Arg(0)->Arg(1);
+
+static void BM_ScrollDelivery(benchmark::State& state) {
+    AScrollEvent e;
+    e.origin = { 10.f, 20.f };
+    e.delta = { 0.f, 120.f };
+    e.kinetic = true;
+    e.pointerIndex = APointerIndex::button(AInput::LBUTTON);
+    deliverEvents(state, "onScroll", "event.kinetic, event.finger", e, [](AView& v, const auto& e) {
+        v.onScroll(e);
+    });
+}
+BENCHMARK(BM_ScrollDelivery)->Arg(0)->Arg(1);
+
+/**
+ * @brief Baseline of BM_PointerPressedDelivery: the event as the table the converter built before LuaEvent, i.e. a
+ * table plus a registry reference per field for every event.
+ */
+static void BM_PointerPressedDeliveryTable(benchmark::State& state) {
+    BenchLua b;
+    auto L = b.state();
+    auto body = state.range(0) ? std::string("local _ = event.button, event.finger") : std::string{};
+    auto handler = b.lua.do_string<clg::function>("return function(self, event) " + body + " end");
+    auto view = b.lua.do_string<_<AView>>("return View()");
+    APointerPressedEvent e;
+    e.position = { 10.f, 20.f };
+    e.pointerIndex = APointerIndex::button(AInput::LBUTTON);
+    e.asButton = AInput::LBUTTON;
+    auto deliver = [&] {
+        handler(view, clg::table{
+            {"position", clg::ref::from_cpp(L, e.position)},
+            {"button", clg::ref::from_cpp(L, e.asButton)},
+            {"finger", clg::ref::from_cpp(L, e.pointerIndex.finger().valueOr(-1))},
+        });
+    };
+    deliver();
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    LuaAllocationCounter counter(L);
+    for (auto _ : state) {
+        deliver();
+    }
+    state.counters["lua_allocs_per_event"] = double(counter.allocations()) / double(state.iterations());
+}
+BENCHMARK(BM_PointerPressedDeliveryTable)->Arg(0)->Arg(1);
@@ -0,0 +1,139 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include <benchmark/benchmark.h>
+#include "BenchLua.h"
+
+static constexpr auto ROW_COUNT = 10'000;
+
+static std::string makeModel() {
+    return "model = {}\n"
+           "for i = 1, " + std::to_string(ROW_COUNT) + " do model[i] = { name = 'row ' .. i } end\n";
+}
+
+/**
+ * @brief ForEachUI over a 10k rows model: setModel + setFactory + layout.
+ */
+static void BM_ForEachUIPopulate(benchmark::State& state) {
+    BenchLua b;
+    b.lua.do_string(makeModel());
+    auto create = b.lua.do_string<clg::function>(R"(
+return function()
+  return ForEachUI():setModel(model):setFactory(function(item) return Label(item.name) end)
+end
+)");
+    for (auto _ : state) {
+        auto list = create.call<_<AView>>();
+        b.surface.addView(list);
+        b.surface.setSize({ 500, 500 });
+        b.surface.applyGeometryToChildrenIfNecessary();
+        b.surface.removeView(list);
+    }
+    state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(BM_ForEachUIPopulate)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Same as BM_ForEachUIPopulate in virtualized mode. Views of visible rows are made on the first frame, which is
+ * not part of this benchmark; what is left is the per-item cost of the model and row offsets.
+ */
+static void BM_ForEachUIPopulateVirtualized(benchmark::State& state) {
+    BenchLua b;
+    b.lua.do_string(makeModel());
+    auto create = b.lua.do_string<clg::function>(R"(
+return function()
+  return ForEachUI():setVirtualized(true):setRowHeight(20):setModel(model):setFactory(function(item) return Label(item.name) end)
+end
+)");
+    for (auto _ : state) {
+        auto list = create.call<_<AView>>();
+        b.surface.addView(list);
+        b.surface.setSize({ 500, 500 });
+        b.surface.applyGeometryToChildrenIfNecessary();
+        b.surface.removeView(list);
+    }
+    state.SetItemsProcessed(state.iterations() * ROW_COUNT);
+}
+BENCHMARK(BM_ForEachUIPopulateVirtualized)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Appending a single row to a 10k rows model and notifying ForEachUI.
+ */
+static void BM_ForEachUIAppend(benchmark::State& state) {
+    BenchLua b;
+    b.lua.do_string(makeModel());
+    auto list = b.lua.do_string<_<AView>>(R"(
+list = ForEachUI():setModel(model):setFactory(function(item) return Label(item.name) end)
+return list
+)");
+    b.surface.addView(list);
+    b.surface.setSize({ 500, 500 });
+    b.surface.applyGeometryToChildrenIfNecessary();
+    auto append = b.lua.do_string<clg::function>(R"(
+return function()
+  model[#model + 1] = { name = 'appended' }
+  list:notify()
+end
+)");
+    // drops the appended row, so every iteration appends to a model of ROW_COUNT rows
+    auto reset = b.lua.do_string<clg::function>(R"(
+return function()
+  model[#model] = nil
+  list:notify()
+end
+)");
+    for (auto _ : state) {
+        append();
+        b.surface.applyGeometryToChildrenIfNecessary();
+
+        state.PauseTiming();
+        reset();
+        b.surface.applyGeometryToChildrenIfNecessary();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_ForEachUIAppend)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Same as BM_ForEachUIAppend, but notifying about the inserted row only.
+ */
+static void BM_ForEachUIAppendNotifyInserted(benchmark::State& state) {
+    BenchLua b;
+    b.lua.do_string(makeModel());
+    auto list = b.lua.do_string<_<AView>>(R"(
+list = ForEachUI():setModel(model):setFactory(function(item) return Label(item.name) end)
+return list
+)");
+    b.surface.addView(list);
+    b.surface.setSize({ 500, 500 });
+    b.surface.applyGeometryToChildrenIfNecessary();
+    auto append = b.lua.do_string<clg::function>(R"(
+return function()
+  model[#model + 1] = { name = 'appended' }
+  list:notifyInserted(#model)
+end
+)");
+    auto reset = b.lua.do_string<clg::function>(R"(
+return function()
+  model[#model] = nil
+  list:notifyRemoved(#model + 1)
+end
+)");
+    for (auto _ : state) {
+        append();
+        b.surface.applyGeometryToChildrenIfNecessary();
+
+        state.PauseTiming();
+        reset();
+        b.surface.applyGeometryToChildrenIfNecessary();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_ForEachUIAppendNotifyInserted)->Unit(benchmark::kMicrosecond);
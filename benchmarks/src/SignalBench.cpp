@@ -0,0 +1,38 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include <benchmark/benchmark.h>
+#include "BenchLua.h"
+
+/**
+ * @brief ForwardSignal dispatch to state.range(0) Lua handlers.
+ * @details
+ * geometryChanged is emitted by AView::setGeometry on every actual change, so the benchmark alternates between two
+ * geometries.
+ */
+static void BM_ForwardSignalDispatch(benchmark::State& state) {
+    BenchLua b;
+    auto view = b.lua.do_string<_<AView>>(R"(
+local v = View()
+counter = 0
+for i = 1, )" + std::to_string(state.range(0)) + R"( do
+  v:geometryChanged(function() counter = counter + 1 end)
+end
+return v
+)");
+    int x = 0;
+    for (auto _ : state) {
+        x ^= 1;
+        view->setGeometry(x, 0, 100, 100);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ForwardSignalDispatch)->Arg(1)->Arg(10)->Arg(100);
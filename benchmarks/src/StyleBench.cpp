@@ -0,0 +1,75 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include <benchmark/benchmark.h>
+#include "BenchLua.h"
+
+static constexpr auto NESTED_STYLE = R"(
+{
+  Button = {
+    BackgroundSolid('#f00'),
+    Padding(4, 8),
+    hover = {
+      BackgroundSolid('#0f0'),
+    },
+    Label = {
+      TextColor('#fff'),
+      FontSize(14),
+    },
+  },
+  Input = {
+    Border(1, '#ccc'),
+    focus = {
+      Border(1, '#00f'),
+    },
+  },
+}
+)";
+
+/**
+ * @brief setStyle with the same nested-selector table applied over and over (StyleHelper::processDeclaration).
+ */
+static void BM_SetStyleNested(benchmark::State& state) {
+    BenchLua b;
+    auto run = b.lua.do_string<clg::function>(std::string("local v = View()\n"
+                                                          "local style = ") + NESTED_STYLE +
+                                              "return function() v:setStyle(style) end");
+    for (auto _ : state) {
+        run();
+    }
+}
+BENCHMARK(BM_SetStyleNested);
+
+/**
+ * @brief setStyle with a style table evaluated on each call, as it happens inside row factories.
+ */
+static void BM_SetStyleNestedFreshTable(benchmark::State& state) {
+    BenchLua b;
+    auto run = b.lua.do_string<clg::function>(std::string("local v = View()\n"
+                                                          "return function() v:setStyle(") + NESTED_STYLE + ") end");
+    for (auto _ : state) {
+        run();
+    }
+}
+BENCHMARK(BM_SetStyleNestedFreshTable);
+
+/**
+ * @brief setStyle with plain declarations (custom style, no selectors).
+ */
+static void BM_SetStyleDeclarations(benchmark::State& state) {
+    BenchLua b;
+    auto run = b.lua.do_string<clg::function>("local v = View()\n"
+                                              "local style = { BackgroundSolid('#f00'), Padding(4), FontSize(14) }\n"
+                                              "return function() v:setStyle(style) end");
+    for (auto _ : state) {
+        run();
+    }
+}
+BENCHMARK(BM_SetStyleDeclarations);
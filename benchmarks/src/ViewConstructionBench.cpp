@@ -0,0 +1,135 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include <benchmark/benchmark.h>
+#include "BenchLua.h"
+
+/**
+ * @brief View construction through ViewExposer::ctor.
+ * @details
+ * Reports construction time per view and Lua heap bytes held by each view while it is alive (lua_bytes_per_view).
+ * Run against the previous revision to compare the per-instance method copying with the shared class metatable.
+ */
+static void BM_ViewConstruction(benchmark::State& state, std::string expression) {
+    BenchLua b;
+    auto one = b.lua.do_string<clg::function>("return function() return " + expression + " end");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(one.call<clg::ref>());
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    constexpr int VIEW_COUNT = 1000;
+    auto many = b.lua.do_string<clg::function>("return function(n) local t = {} for i = 1, n do t[i] = " + expression + " end return t end");
+    auto before = b.heapBytes();
+    auto views = many.call<clg::ref>(VIEW_COUNT);
+    auto after = b.heapBytes();
+    state.counters["lua_bytes_per_view"] = (double(after) - double(before)) / VIEW_COUNT;
+}
+
+BENCHMARK_CAPTURE(BM_ViewConstruction, View, std::string("View()"));
+BENCHMARK_CAPTURE(BM_ViewConstruction, Input, std::string("Input('')"));
+BENCHMARK_CAPTURE(BM_ViewConstruction, Checkbox, std::string("Checkbox()"));
+BENCHMARK_CAPTURE(BM_ViewConstruction, Slider, std::string("Slider()"));
+
+/**
+ * @brief Rebuilding a 500 children panel attached to the surface with removeAllViews + addView, without
+ * (range(0) == 0) and with (range(0) == 1) UI.batch.
+ */
+static void BM_RebuildPanel(benchmark::State& state) {
+    constexpr int CHILD_COUNT = 500;
+    BenchLua b;
+    auto panel = b.lua.do_string<_<AView>>("panel = Vertical {} return panel");
+    b.surface.addView(panel);
+    b.surface.setSize({ 500, 500 });
+    auto rebuild = b.lua.do_string<clg::function>(R"(
+return function(n, batched)
+  local function fill()
+    panel:removeAllViews()
+    for i = 1, n do panel:addView(Label('row')) end
+  end
+  if batched then UI.batch(fill) else fill() end
+end
+)");
+    for (auto _ : state) {
+        rebuild(CHILD_COUNT, state.range(0) != 0);
+        b.surface.applyGeometryToChildrenIfNecessary();
+    }
+    state.SetItemsProcessed(state.iterations() * CHILD_COUNT);
+}
+BENCHMARK(BM_RebuildPanel)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Same as BM_RebuildPanel, with a single replaceChildren call.
+ */
+static void BM_RebuildPanelReplaceChildren(benchmark::State& state) {
+    constexpr int CHILD_COUNT = 500;
+    BenchLua b;
+    auto panel = b.lua.do_string<_<AView>>("panel = Vertical {} return panel");
+    b.surface.addView(panel);
+    b.surface.setSize({ 500, 500 });
+    auto rebuild = b.lua.do_string<clg::function>(R"(
+return function(n)
+  local children = {}
+  for i = 1, n do children[i] = Label('row') end
+  panel:replaceChildren(children)
+end
+)");
+    for (auto _ : state) {
+        rebuild(CHILD_COUNT);
+        b.surface.applyGeometryToChildrenIfNecessary();
+    }
+    state.SetItemsProcessed(state.iterations() * CHILD_COUNT);
+}
+BENCHMARK(BM_RebuildPanelReplaceChildren)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Building a tree of range(0) views from Lua: containers of 100 labels under a root container, i.e. anchoring
+ * each view as a child.
+ * @details
+ * Reports build time per view, Lua heap bytes held per view while the tree is alive (lua_bytes_per_view) and Lua
+ * allocations made per view by the build (lua_allocations_per_view). Child slot bookkeeping is C++ heap memory and
+ * shows in the process' peak RSS rather than in these counters.
+ */
+static void BM_BuildLargeTree(benchmark::State& state) {
+    BenchLua b;
+    auto build = b.lua.do_string<clg::function>(R"(
+return function(n)
+  local groups = {}
+  for g = 1, n // 100 do
+    local group = Vertical {}
+    for i = 1, 100 do group:addView(Label('node')) end
+    groups[g] = group
+  end
+  return Vertical(groups)
+end
+)");
+    const auto viewCount = int(state.range(0));
+    for (auto _ : state) {
+        auto tree = build.call<_<AView>>(viewCount);
+        state.PauseTiming();
+        tree = nullptr;
+        lua_gc(b.state(), LUA_GCCOLLECT, 0);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * viewCount);
+
+    auto before = b.heapBytes();
+    _<AView> tree;
+    std::size_t allocations;
+    {
+        LuaAllocationCounter counter(b.state());
+        tree = build.call<_<AView>>(viewCount);
+        allocations = counter.allocations();
+    }
+    auto after = b.heapBytes();
+    state.counters["lua_bytes_per_view"] = (double(after) - double(before)) / viewCount;
+    state.counters["lua_allocations_per_view"] = double(allocations) / viewCount;
+}
+BENCHMARK(BM_BuildLargeTree)->Arg(20000)->Arg(50000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,38 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Same as benchmark_main, but prints json unless --benchmark_format is passed explicitly.
+ */
+int main(int argc, char** argv) {
+    std::vector<char*> args(argv, argv + argc);
+    char jsonFormat[] = "--benchmark_format=json";
+    if (std::none_of(args.begin(), args.end(), [](const char* arg) {
+            return std::string_view(arg).starts_with("--benchmark_format");
+        })) {
+        args.push_back(jsonFormat);
+    }
+    int count = int(args.size());
+    args.push_back(nullptr);
+
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+    benchmark::AddCustomContext("aui_version", AUI_LUA_BENCH_AUI_VERSION);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
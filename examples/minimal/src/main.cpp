@@ -17,7 +17,8 @@ AUI_ENTRY {
   auto w = _new<AWindow>("Example", 500_dp, 400_dp);
   static UIEngine uiEngine(*w);
   auto main = AString::fromUtf8(AByteBuffer::fromStream(":main.lua"_url.open())).toStdString();
-  clg::state_interface(clg::state()).do_string(main);
+  // compiled on a worker thread; the window shows up without waiting for it
+  uiEngine.runAsync(std::move(main), "=main.lua");
   w->show();
 
   return 0;
@@ -21,8 +21,14 @@
 #include "converter.hpp"
 #include "lua.h"
 #include "table.hpp"
+#include <concepts>
 #include <optional>
+#include <string_view>
+#include <type_traits>
 #include <uiengine/ILuaExposedView.h>
+#include <uiengine/LuaEvent.h>
+#include <uiengine/LuaVec.h>
+#include <AUI/Common/AByteBufferView.h>
 #include <AUI/Common/AColor.h>
 #include <AUI/ASS/ASS.h>
 #include <uiengine/ILuaExposedView.h>
@@ -45,17 +51,63 @@ namespace clg {
     template<typename T>
     struct converter<AVector<T>>: converter_derived<std::vector<T>, AVector<T>> {};
 
+    namespace aui_string {
+        template<typename String>
+        concept utf8_storage = requires(const String& s) {
+            { s.data() } -> std::convertible_to<const char*>;
+            { s.size() } -> std::convertible_to<std::size_t>;
+        };
+
+        /**
+         * @brief Builds the string right from the bytes owned by Lua (no intermediate std::string).
+         */
+        template<typename String = AString>
+        String from_utf8(const char* data, std::size_t length) {
+            if constexpr (utf8_storage<String> && std::is_constructible_v<String, const char*, std::size_t>) {
+                return String(data, length);
+            } else {
+                return String::fromUtf8(AByteBufferView(data, length));
+            }
+        }
+
+        /**
+         * @brief Pushes the string; UTF-8 strings are pushed from their own buffer.
+         */
+        template<typename String = AString>
+        void push(lua_State* l, const String& v) {
+            if constexpr (utf8_storage<String>) {
+                lua_pushlstring(l, v.data(), v.size());
+            } else {
+                auto utf8 = v.toStdString();
+                lua_pushlstring(l, utf8.data(), utf8.size());
+            }
+        }
+    }
+
     template<>
     struct converter<AString> {
         static converter_result<AString> from_lua(lua_State* l, int n) {
-            auto r = clg::get_from_lua_raw<std::string>(l, n);
-            if (r.is_error()) {
-                return r.error();
+            std::size_t length = 0;
+            switch (lua_type(l, n)) {
+                case LUA_TSTRING: {
+                    auto data = lua_tolstring(l, n, &length);
+                    return aui_string::from_utf8(data, length);
+                }
+                case LUA_TNUMBER: {
+                    // lua_tolstring would turn the slot itself into a string, which breaks lua_next over a key; a copy
+                    // is converted instead
+                    lua_pushvalue(l, n);
+                    auto data = lua_tolstring(l, -1, &length);
+                    auto result = aui_string::from_utf8(data, length);
+                    lua_pop(l, 1);
+                    return result;
+                }
+                default:
+                    return converter_error{"expected string"};
             }
-            return *r;
         }
         static int to_lua(lua_State* l, const AString& v) {
-            clg::push_to_lua(l, v.toStdString());
+            aui_string::push(l, v);
             return 1;
         }
     };
@@ -63,14 +115,14 @@ namespace clg {
     template<>
     struct converter<APath> {
         static converter_result<APath> from_lua(lua_State* l, int n) {
-            auto r = clg::get_from_lua_raw<AString>(l, n);
+            auto r = converter<AString>::from_lua(l, n);
             if (r.is_error()) {
                 return r.error();
             }
-            return APath(*r);
+            return APath(std::move(*r));
         }
         static int to_lua(lua_State* l, const APath& v) {
-            clg::push_to_lua(l, v.toStdString());
+            aui_string::push<AString>(l, v);
             return 1;
         }
     };
@@ -111,35 +163,91 @@ namespace clg {
         }
     };
 
+    namespace detail {
+        inline int event_finger(const APointerIndex& pointerIndex) {
+            return pointerIndex.finger().valueOr(-1);
+        }
+
+        struct pointer_move_event_fields {
+            static bool push(lua_State* l, const APointerMoveEvent& v, std::string_view key) {
+                if (key == "finger") {
+                    clg::push_to_lua(l, event_finger(v.pointerIndex));
+                    return true;
+                }
+                return false;
+            }
+        };
+
+        struct pointer_pressed_event_fields {
+            static bool push(lua_State* l, const APointerPressedEvent& v, std::string_view key) {
+                if (key == "position") {
+                    clg::push_to_lua(l, v.position);
+                } else if (key == "button") {
+                    clg::push_to_lua(l, v.asButton);
+                } else if (key == "finger") {
+                    clg::push_to_lua(l, event_finger(v.pointerIndex));
+                } else {
+                    return false;
+                }
+                return true;
+            }
+        };
+
+        struct pointer_released_event_fields {
+            static bool push(lua_State* l, const APointerReleasedEvent& v, std::string_view key) {
+                if (key == "position") {
+                    clg::push_to_lua(l, v.position);
+                } else if (key == "button") {
+                    clg::push_to_lua(l, v.asButton);
+                } else if (key == "triggerClick") {
+                    clg::push_to_lua(l, v.triggerClick);
+                } else if (key == "finger") {
+                    clg::push_to_lua(l, event_finger(v.pointerIndex));
+                } else {
+                    return false;
+                }
+                return true;
+            }
+        };
+
+        struct scroll_event_fields {
+            static bool push(lua_State* l, const AScrollEvent& v, std::string_view key) {
+                if (key == "origin") {
+                    clg::push_to_lua(l, v.origin);
+                } else if (key == "delta") {
+                    clg::push_to_lua(l, v.delta);
+                } else if (key == "kinetic") {
+                    clg::push_to_lua(l, v.kinetic);
+                } else if (key == "button") {
+                    clg::push_to_lua(l, v.pointerIndex.button().valueOr(AInput::LBUTTON));
+                } else if (key == "finger") {
+                    clg::push_to_lua(l, event_finger(v.pointerIndex));
+                } else {
+                    return false;
+                }
+                return true;
+            }
+        };
+    }
+
     template<>
     struct converter<APointerMoveEvent> {
         static int to_lua(lua_State* l, const APointerMoveEvent& v) {
-            return clg::push_to_lua(l, clg::table{
-                {"finger", clg::ref::from_cpp(l, v.pointerIndex.finger().valueOr(-1))},
-            });
+            return LuaEvent<APointerMoveEvent, detail::pointer_move_event_fields>::push(l, v);
         }
     };
 
     template<>
     struct converter<APointerPressedEvent> {
         static int to_lua(lua_State* l, const APointerPressedEvent& v) {
-            return clg::push_to_lua(l, clg::table{
-                {"position", clg::ref::from_cpp(l, v.position)},
-                {"button", clg::ref::from_cpp(l, v.asButton)},
-                {"finger", clg::ref::from_cpp(l, v.pointerIndex.finger().valueOr(-1))},
-            });
+            return LuaEvent<APointerPressedEvent, detail::pointer_pressed_event_fields>::push(l, v);
         }
     };
 
     template<>
     struct converter<APointerReleasedEvent> {
         static int to_lua(lua_State* l, const APointerReleasedEvent& v) {
-            return clg::push_to_lua(l, clg::table{
-                {"position", clg::ref::from_cpp(l, v.position)},
-                {"button", clg::ref::from_cpp(l, v.asButton)},
-                {"triggerClick", clg::ref::from_cpp(l, v.triggerClick)},
-                {"finger", clg::ref::from_cpp(l, v.pointerIndex.finger().valueOr(-1))},
-            });
+            return LuaEvent<APointerReleasedEvent, detail::pointer_released_event_fields>::push(l, v);
         }
     };
 
@@ -154,13 +262,7 @@ namespace clg {
     template<>
     struct converter<AScrollEvent> {
         static int to_lua(lua_State* l, const AScrollEvent& v) {
-            return clg::push_to_lua(l, clg::table{
-                {"origin", clg::ref::from_cpp(l, v.origin)},
-                {"delta", clg::ref::from_cpp(l, v.delta)},
-                {"kinetic", clg::ref::from_cpp(l, v.kinetic)},
-                {"button", clg::ref::from_cpp(l, v.pointerIndex.button().valueOr(AInput::LBUTTON))},
-                {"finger", clg::ref::from_cpp(l, v.pointerIndex.finger().valueOr(-1))},
-            });
+            return LuaEvent<AScrollEvent, detail::scroll_event_fields>::push(l, v);
         }
     };
 
@@ -174,16 +276,12 @@ namespace clg {
             return *r;
         }
         static int to_lua(lua_State* l, const AStringVector& v) {
-            clg::table_array tableArray;
-            tableArray.reserve(v.size());
-
-            for (const auto& string : v) {
-                clg::stack_integrity_check check(l);
-                clg::push_to_lua(l, string);
-                auto asRef = clg::ref::from_stack(l);
-                tableArray.push_back(std::move(asRef));
+            lua_createtable(l, int(v.size()), 0);
+            for (std::size_t i = 0; i < v.size(); ++i) {
+                aui_string::push(l, v[i]);
+                lua_rawseti(l, -2, lua_Integer(i + 1));
             }
-            return clg::push_to_lua(l, tableArray);
+            return 1;
         }
     };
 
@@ -199,6 +297,25 @@ namespace clg {
             }
             auto& v = *r;
             if (!v) return nullptr;
+            if constexpr (std::is_same_v<T, AView>) {
+                auto view = v->view();
+                return std::shared_ptr<T>(std::move(v), view);
+            } else if constexpr (!std::is_base_of_v<ILuaExposedView, T>) {
+                if (auto exposed = v->template exposedAs<T>()) {
+                    return std::shared_ptr<T>(std::move(v), exposed);
+                }
+                if constexpr (std::is_same_v<T, AViewContainer>) {
+                    if (auto container = v->container()) {
+                        return std::shared_ptr<T>(std::move(v), container);
+                    }
+                }
+                if constexpr (std::is_same_v<T, AViewContainerBase>) {
+                    if (auto container = v->containerBase()) {
+                        return std::shared_ptr<T>(std::move(v), container);
+                    }
+                }
+            }
+            // requested type differs from the exposed one (i.e. base or derived class)
             return _cast<T>(std::move(v));
         }
         static int to_lua(lua_State* l, const std::shared_ptr<T>& v) {
@@ -206,8 +323,10 @@ namespace clg {
                 lua_pushnil(l);
                 return 1;
             }
-            if (auto lua = std::dynamic_pointer_cast<ILuaExposedView>(v)) {
-                return clg::push_to_lua(l, lua);
+            if constexpr (std::is_base_of_v<ILuaExposedView, T>) {
+                return clg::push_to_lua(l, std::static_pointer_cast<ILuaExposedView>(v));
+            } else if (auto lua = ILuaExposedView::fromView(v.get())) {
+                return clg::push_to_lua(l, std::shared_ptr<ILuaExposedView>(v, lua));
             }
             assert(("non lua-compatible view pushed to lua", false));
             return 0;
@@ -305,7 +424,22 @@ namespace clg {
         using vec = glm::vec<N, T, Q>;
         using my_array_like_converter = array_like_converter<vec, detail::array_like_converter_glm_vec_helper<T, N, Q>>;
 
+        /**
+         * @brief Whether the vector crosses the boundary as LuaVec userdata (bool vectors stay tables).
+         */
+        static constexpr bool AS_LUA_VEC = N <= LuaVec::MAX_SIZE && std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
         static converter_result<vec> from_lua(lua_State* l, int n) {
+            if constexpr (AS_LUA_VEC) {
+                LuaVec::Value value;
+                if (LuaVec::get(l, n, value) && value.size >= N) {
+                    vec result;
+                    for (int i = 0; i < N; ++i) {
+                        result[i] = static_cast<T>(value.components[i]);
+                    }
+                    return result;
+                }
+            }
             if (lua_istable(l, n)) {
                 auto len = lua_rawlen(l, n);
                 if (len < N) {
@@ -315,11 +449,22 @@ namespace clg {
                 return my_array_like_converter::from_lua(l, n);
             }
             error:
-            static std::string e = "expected table of size " + std::to_string(N) + " (vec" + std::to_string(N) + ")";
+            static std::string e = "expected vec" + std::to_string(N) + " or table of size " + std::to_string(N);
             return converter_error{e.c_str()};
         }
         static int to_lua(lua_State* l, vec v) {
-            return my_array_like_converter::to_lua(l, v);
+            if constexpr (AS_LUA_VEC) {
+                LuaVec::Value value;
+                value.size = N;
+                value.integral = std::is_integral_v<T>;
+                for (int i = 0; i < N; ++i) {
+                    value.components[i] = static_cast<lua_Number>(v[i]);
+                }
+                LuaVec::push(l, value);
+                return 1;
+            } else {
+                return my_array_like_converter::to_lua(l, v);
+            }
         }
     };
 
@@ -432,7 +577,7 @@ namespace clg {
         }
 
         static int to_lua(lua_State* l, const ARenderContext& look) {
-            // луашерам это незачем
+            // the context is only valid during the frame; Lua draws with view:setDraw (see LuaCanvas)
             lua_pushnil(l);
             return 1;
         }
@@ -12,21 +12,284 @@
 
 
 #include "clg.hpp"
+#include <array>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
 #include <AUI/View/AView.h>
+#include <AUI/View/AViewContainer.h>
+#include "LuaSignalHandlers.h"
 
 class UIEngine;
+class LuaCanvas;
+class IRenderer;
+
+/**
+ * @brief Class id of a LuaExposedView<T>. Ids are compared by address, one per T.
+ */
+template<typename T>
+const void* luaExposedClassId() noexcept {
+    static const char id = 0;
+    return &id;
+}
 
 class ILuaExposedView: public clg::lua_self {
 public:
     ILuaExposedView(UIEngine& uiEngine) : mUiEngine(uiEngine) {}
 
-    virtual ~ILuaExposedView() = default;
+    virtual ~ILuaExposedView();
+
+    [[nodiscard]]
+    UIEngine& uiEngine() const noexcept {
+        return mUiEngine;
+    }
+
+    /**
+     * @brief Called by the generated render override; drives per-frame work of the engine (see LuaGcPacer).
+     */
+    void luaFrameRendered();
 
     [[nodiscard]]
     virtual AView* view() noexcept = 0;
 
+    /**
+     * @return the exposed object if this view was exposed exactly as T; nullptr otherwise.
+     * @details
+     * Replaces dynamic_cast on hot binding paths: a single pointer compare followed by a static cast.
+     */
+    template<typename T>
+    [[nodiscard]]
+    T* exposedAs() const noexcept {
+        if (mClassId != luaExposedClassId<T>()) {
+            return nullptr;
+        }
+        return static_cast<T*>(mExposedObject);
+    }
+
+    [[nodiscard]]
+    AViewContainerBase* containerBase() const noexcept {
+        return mContainerBase;
+    }
+
+    [[nodiscard]]
+    AViewContainer* container() const noexcept {
+        return mContainer;
+    }
+
+    /**
+     * @brief Finds the ILuaExposedView part of a view without dynamic_cast.
+     * @return nullptr if the view was not created by LuaExposedView.
+     * @details
+     * The dynamic type of the view (its vtable) serves as the class id: it is looked up in a lock-free table of the
+     * LuaExposedView classes, which holds the offset of the ILuaExposedView part. A class is added to the table once,
+     * when its first instance is constructed; if the table is full, an error is logged and lookups fall back to
+     * dynamic_cast.
+     *
+     * Classes are keyed by the address of their type_info. With shared libraries a class may have a type_info per
+     * library; it is registered by the library that constructs its instances, i.e. the one whose vtable the instances
+     * carry, so typeid of an instance yields the registered address.
+     */
+    static ILuaExposedView* fromView(const AView* view) noexcept;
+
+    /**
+     * @brief Lua handlers of the signal, keyed by the signal's address.
+     * @return nullptr if no Lua handler was ever connected to the signal.
+     */
+    [[nodiscard]]
+    LuaSignalHandlers* findSignalHandlers(const void* signal) noexcept {
+        if (auto it = mSignalHandlers.find(signal); it != mSignalHandlers.end()) {
+            return &it->second;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Lua handlers of the signal, keyed by the signal's address. Created on first access.
+     * @return handlers and whether they were just created (i.e., the C++ connection has to be made).
+     */
+    std::pair<LuaSignalHandlers&, bool> signalHandlers(const void* signal) {
+        auto [it, created] = mSignalHandlers.try_emplace(signal);
+        return { it->second, created };
+    }
+
+    /**
+     * @brief Sets the Lua function recording the view's draw commands (see LuaCanvas); nil removes it.
+     */
+    void setDraw(const clg::ref& draw);
+
+    /**
+     * @brief Records the draw commands again on the next frame.
+     */
+    void invalidateDraw();
+
+    /**
+     * @brief Commands recorded by the draw function; nullptr if there is no draw function.
+     */
+    [[nodiscard]]
+    const LuaCanvas* canvas() const noexcept {
+        return mCanvas.get();
+    }
+
+    /**
+     * @brief Called by the generated render override after the base class has rendered; replays the recorded draw
+     * commands, recording them first if they are out of date.
+     */
+    void luaRenderCanvas(IRenderer& render);
+
+    /**
+     * @brief Minimum size queries that can be overridden from Lua.
+     */
+    enum class MinSizeQuery {
+        CONTENT_WIDTH,
+        CONTENT_HEIGHT,
+        WIDTH,
+        HEIGHT,
+    };
+
+    /**
+     * @brief Caches results of the Lua min size overrides until markMinContentSizeInvalid (or invalidate() from Lua).
+     * @details
+     * Off by default: an override that depends on state the view does not know about (Lua globals, other views) has to
+     * call invalidate() when that state changes.
+     */
+    void setMinSizeMemoization(bool enabled);
+
+    [[nodiscard]]
+    bool minSizeMemoization() const noexcept {
+        return mMinSizeMemo != nullptr;
+    }
+
+    /**
+     * @brief Result of the Lua override cached since the last invalidation. Counts a hit or a miss of the engine's
+     * UIEngine::MinSizeMemoStats.
+     * @return nullopt if memoization is off or nothing is cached.
+     */
+    std::optional<int> memoizedMinSize(MinSizeQuery query);
+
+    /**
+     * @brief Caches a result of the Lua override (if memoization is on).
+     * @return value
+     */
+    int memoizeMinSize(MinSizeQuery query, int value) noexcept {
+        if (mMinSizeMemo) {
+            (*mMinSizeMemo)[static_cast<std::size_t>(query)] = value;
+        }
+        return value;
+    }
+
+    void invalidateMinSizeMemo() noexcept {
+        if (mMinSizeMemo) {
+            mMinSizeMemo->fill(std::nullopt);
+        }
+    }
+
+    /**
+     * @brief Compiled style (StyleCache entry) last applied by setStyle; nullptr if none.
+     */
+    [[nodiscard]]
+    const std::shared_ptr<const void>& appliedStyle() const noexcept {
+        return mAppliedStyle;
+    }
+
+    void setAppliedStyle(std::shared_ptr<const void> style) noexcept {
+        mAppliedStyle = std::move(style);
+    }
+
+    /**
+     * @brief Whether Lua code attached anything to this view: signal handlers, fields or overrides.
+     */
+    [[nodiscard]]
+    bool hasLuaState();
+
+    /**
+     * @brief Keeps the Lua objects of the children alive while they are in this container.
+     * @details
+     * Children are stored in a single Lua array ("cpp_children" of the data holder); their slots are tracked on the
+     * C++ side, so adding or removing a child is a raw array write and the GC traverses one array instead of a hash
+     * table keyed by userdata. Freed slots are reused to keep the array dense. Already anchored children are skipped.
+     *
+     * The slot of a LuaExposedView child is stored on the child itself, next to the container that anchored it; the
+     * container keeps only a flat array slot -> child, which confirms the child's record. Other children are found by
+     * scanning that array.
+     */
+    void anchorChildren(std::span<const _<AView>> views);
+
+    void releaseChildren(std::span<const _<AView>> views);
+
+    void releaseAllChildren();
+
+    [[nodiscard]]
+    std::size_t anchoredChildCount() const noexcept {
+        return mSlotViews.size() - mFreeChildSlots.size();
+    }
+
+protected:
+    /**
+     * @param self the exposed object.
+     * @param type typeid of the most derived class, i.e. LuaExposedView<View>.
+     */
+    template<typename View>
+    void bindExposedClass(View* self, const std::type_info& type) {
+        mClassId = luaExposedClassId<View>();
+        mExposedObject = self;
+        if constexpr (std::is_base_of_v<AViewContainerBase, View>) {
+            mContainerBase = self;
+        }
+        if constexpr (std::is_base_of_v<AViewContainer, View>) {
+            mContainer = self;
+        }
+        static const bool registered = (registerClass(type, static_cast<const AView*>(self)), true);
+        (void) registered;
+    }
+
 private:
     UIEngine& mUiEngine;
-};
+    const void* mClassId = nullptr;
+    void* mExposedObject = nullptr;
+    AViewContainerBase* mContainerBase = nullptr;
+    AViewContainer* mContainer = nullptr;
+    std::unordered_map<const void*, LuaSignalHandlers> mSignalHandlers;
 
+    /**
+     * @brief Child anchored at each slot of the Lua array (slot - 1); nullptr for free slots.
+     */
+    std::vector<const AView*> mSlotViews;
+    std::vector<int> mFreeChildSlots;
 
+    /**
+     * @brief Container that anchored this view as a child (only compared, never dereferenced) and the slot.
+     */
+    const ILuaExposedView* mAnchorOwner = nullptr;
+    int mAnchorSlot = 0;
+    std::shared_ptr<const void> mAppliedStyle;
+    std::unique_ptr<std::array<std::optional<int>, 4>> mMinSizeMemo;
+    std::shared_ptr<LuaCanvas> mCanvas;
+    bool mCanvasDirty = false;
+    glm::ivec2 mCanvasSize{0};
+
+    /**
+     * @brief Adds the class of view to the fromView table.
+     */
+    void registerClass(const std::type_info& type, const AView* view);
+
+    /**
+     * @brief Pushes the array of anchored children; creates it if requested.
+     * @return false (nothing pushed) if there is no array or the data holder is not initialized yet.
+     */
+    bool pushChildAnchors(lua_State* L, bool create);
+
+    /**
+     * @brief Takes a free slot of the array for the view and records it.
+     */
+    int takeChildSlot(const AView* view);
+
+    /**
+     * @return slot of the view in the array; 0 if it is not anchored by this container.
+     * @param scan whether to search the array for a view whose record does not point to this container.
+     */
+    int findChildSlot(const AView* view, bool scan) const noexcept;
+};
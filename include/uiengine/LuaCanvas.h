@@ -0,0 +1,125 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#pragma once
+
+#include <clg.hpp>
+#include <AUI/Common/AColor.h>
+#include <AUI/Common/AString.h>
+#include <AUI/Image/IDrawable.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+class IRenderer;
+
+/**
+ * @brief Retained list of draw commands recorded by a Lua draw function (view:setDraw).
+ * @details
+ * The draw function is called with the view and a canvas to record into; the recorded commands are replayed on every
+ * frame without calling Lua, until the view is resized or view:invalidateDraw() is called. Coordinates and sizes are
+ * in pixels, relative to the view.
+ * @code{lua}
+ * gauge = View():setDraw(function(self, canvas)
+ *   local w, h = self:getSize2()
+ *   canvas:roundedRect(0, 0, w, h, 8, '#202020')
+ *   canvas:rect(0, 0, w * value, h, '#4caf50')
+ *   canvas:text(8, 8, tostring(value), '#ffffff', 14)
+ * end)
+ * value = 0.7
+ * gauge:invalidateDraw()
+ * @endcode
+ */
+class LuaCanvas: public std::enable_shared_from_this<LuaCanvas> {
+public:
+    struct Rect {
+        glm::vec2 position;
+        glm::vec2 size;
+        AColor color;
+        float radius = 0.f;
+
+        /**
+         * @brief Width of the border; 0 fills the rectangle.
+         */
+        float borderWidth = 0.f;
+    };
+
+    struct Lines {
+        std::vector<glm::vec2> points;
+        AColor color;
+        float width = 1.f;
+    };
+
+    struct Text {
+        glm::vec2 position;
+        AString text;
+        AColor color;
+        unsigned size = 12;
+    };
+
+    struct Image {
+        _<IDrawable> drawable;
+        glm::vec2 position;
+        glm::vec2 size;
+    };
+
+    using Command = std::variant<Rect, Lines, Text, Image>;
+
+    /**
+     * @brief Registers the Canvas class of the methods available to draw functions.
+     */
+    static void registerClass(lua_State* L);
+
+    void clear() noexcept {
+        mCommands.clear();
+    }
+
+    void add(Command command) {
+        mCommands.push_back(std::move(command));
+    }
+
+    /**
+     * @brief Drawable of the image url; loaded once per canvas, in the background.
+     * @return nullptr until the image is loaded (or if it failed to load).
+     * @details
+     * The first request of an url starts loading it on the thread pool; the draw function is not blocked on it. Once
+     * the image is loaded, the callback set by setOnImageLoaded is called on the main thread to record the commands
+     * again.
+     */
+    _<IDrawable> image(const std::string& url);
+
+    void setOnImageLoaded(std::function<void()> onImageLoaded) {
+        mOnImageLoaded = std::move(onImageLoaded);
+    }
+
+    void replay(IRenderer& render) const;
+
+    [[nodiscard]]
+    std::size_t size() const noexcept {
+        return mCommands.size();
+    }
+
+    [[nodiscard]]
+    const std::vector<Command>& commands() const noexcept {
+        return mCommands;
+    }
+
+private:
+    std::vector<Command> mCommands;
+    std::unordered_map<std::string, _<IDrawable>> mImages;
+    std::unordered_set<std::string> mLoadingImages;
+    std::function<void()> mOnImageLoaded;
+};
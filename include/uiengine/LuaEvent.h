@@ -0,0 +1,175 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#pragma once
+
+#include "lua.h"
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string_view>
+
+/**
+ * @brief Marks the delivery of C++ arguments to a Lua handler (emitted by lua_reflection.py around the Lua call of an
+ * override taking an event); lets LuaEvent tell a nested dispatch from a sequential one.
+ * @details
+ * Dispatches form a per-thread stack of objects living on the C++ stack, so entering one does not allocate.
+ */
+class LuaEventDispatch {
+public:
+    LuaEventDispatch() noexcept: mId(++lastId()), mOuter(current()) {
+        current() = this;
+    }
+
+    ~LuaEventDispatch() {
+        current() = mOuter;
+    }
+
+    LuaEventDispatch(const LuaEventDispatch&) = delete;
+    LuaEventDispatch& operator=(const LuaEventDispatch&) = delete;
+
+    /**
+     * @return id of the innermost dispatch of this thread; 0 if there is none.
+     */
+    [[nodiscard]]
+    static std::uint64_t currentId() noexcept {
+        return current() ? current()->mId : 0;
+    }
+
+    /**
+     * @return whether the dispatch is still running, enclosing the innermost one.
+     */
+    [[nodiscard]]
+    static bool isEnclosing(std::uint64_t id) noexcept {
+        if (id == 0 || current() == nullptr) {
+            return false;
+        }
+        for (auto d = current()->mOuter; d != nullptr; d = d->mOuter) {
+            if (d->mId == id) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::uint64_t mId;
+    LuaEventDispatch* mOuter;
+
+    static LuaEventDispatch*& current() noexcept {
+        thread_local LuaEventDispatch* c = nullptr;
+        return c;
+    }
+
+    static std::uint64_t& lastId() noexcept {
+        thread_local std::uint64_t id = 0;
+        return id;
+    }
+};
+
+/**
+ * @brief Pushes input events to Lua as a reusable userdata with lazily materialized fields.
+ * @tparam Event event type.
+ * @tparam Fields struct with static bool push(lua_State*, const Event&, std::string_view key) that pushes exactly one
+ *         value for a known key and returns true, or pushes nothing and returns false.
+ * @details
+ * Each lua_State holds a single userdata per event type (anchored in the registry), which is overwritten by every
+ * push. Pushing an event therefore does not allocate on the Lua heap; fields are pushed on access only.
+ *
+ * As a consequence, an event is valid during the callback it was passed to only; the values of a retained event change
+ * as new events of the same type arrive. Lua code should copy the fields it needs to keep.
+ *
+ * Nested dispatch is detected: if the shared userdata was pushed by a dispatch (LuaEventDispatch) that is still running
+ * (its handler made another view receive an event of the same type), a fresh userdata is pushed instead, so the outer
+ * handler keeps seeing its own event.
+ */
+template<typename Event, typename Fields>
+class LuaEvent {
+public:
+    static int push(lua_State* l, const Event& event) {
+        if (lua_rawgetp(l, LUA_REGISTRYINDEX, key()) != LUA_TUSERDATA) {
+            lua_pop(l, 1);
+            create(l);
+            lua_pushvalue(l, -1);
+            lua_rawsetp(l, LUA_REGISTRYINDEX, key());
+        }
+        auto storage = static_cast<Storage*>(lua_touserdata(l, -1));
+        if (storage->initialized && LuaEventDispatch::isEnclosing(storage->dispatch)) {
+            lua_pop(l, 1);
+            create(l);
+            storage = static_cast<Storage*>(lua_touserdata(l, -1));
+        }
+        if (storage->initialized) {
+            std::destroy_at(storage->event());
+        }
+        new (&storage->data) Event(event);
+        storage->initialized = true;
+        storage->dispatch = LuaEventDispatch::currentId();
+        return 1;
+    }
+
+private:
+    struct Storage {
+        alignas(Event) unsigned char data[sizeof(Event)];
+        bool initialized = false;
+
+        /**
+         * @brief LuaEventDispatch that pushed the event.
+         */
+        std::uint64_t dispatch = 0;
+
+        Event* event() noexcept {
+            return std::launder(reinterpret_cast<Event*>(&data));
+        }
+    };
+
+    static const void* key() noexcept {
+        static const char k = 0;
+        return &k;
+    }
+
+    static void create(lua_State* l) {
+#if LUA_VERSION_NUM >= 504
+        new (lua_newuserdatauv(l, sizeof(Storage), 0)) Storage;
+#else
+        new (lua_newuserdata(l, sizeof(Storage))) Storage;
+#endif
+
+        lua_createtable(l, 0, 2);
+        lua_pushcfunction(l, index);
+        lua_setfield(l, -2, "__index");
+        lua_pushcfunction(l, gc);
+        lua_setfield(l, -2, "__gc");
+        lua_setmetatable(l, -2);
+    }
+
+    static int index(lua_State* l) {
+        auto storage = static_cast<Storage*>(lua_touserdata(l, 1));
+        std::size_t length = 0;
+        const char* name = lua_type(l, 2) == LUA_TSTRING ? lua_tolstring(l, 2, &length) : nullptr;
+        if (storage == nullptr || !storage->initialized || name == nullptr) {
+            lua_pushnil(l);
+            return 1;
+        }
+        if (!Fields::push(l, *storage->event(), std::string_view(name, length))) {
+            lua_pushnil(l);
+        }
+        return 1;
+    }
+
+    static int gc(lua_State* l) {
+        auto storage = static_cast<Storage*>(lua_touserdata(l, 1));
+        if (storage != nullptr && storage->initialized) {
+            std::destroy_at(storage->event());
+            storage->initialized = false;
+        }
+        return 0;
+    }
+};
@@ -0,0 +1,116 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#pragma once
+
+#include <clg.hpp>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <memory>
+
+/**
+ * @brief Runs Lua garbage collection in budgeted steps after frames instead of at allocation time.
+ * @details
+ * When enabled, allocation-driven collection is stopped; the first rendered Lua view of a frame schedules a step to
+ * the UI thread's queue, which runs after the frame is rendered. A step does incremental collection work until the
+ * budget runs out or a cycle completes. If the heap outgrows twice its size at the end of the last cycle (the steps
+ * do not keep up with allocations), the step runs a full collection regardless of the budget.
+ *
+ * In generational mode (Lua 5.4+; older versions stay incremental) a step is a single minor collection, which cannot
+ * be split by the budget; Lua turns it into a major one when the old generation has grown enough. The full collection
+ * above still applies if the heap outgrows twice its size after the last full collection.
+ */
+class LuaGcPacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Mode {
+        INCREMENTAL,
+        GENERATIONAL,
+    };
+
+    /**
+     * @brief Pause statistics over the last second.
+     */
+    struct Stats {
+        std::chrono::microseconds maxPause{0};
+        std::chrono::microseconds p99Pause{0};
+        std::chrono::microseconds totalPerSecond{0};
+        std::size_t steps = 0;
+
+        /**
+         * @brief Completed incremental cycles, or collections in generational mode.
+         */
+        std::size_t cycles = 0;
+    };
+
+    explicit LuaGcPacer(lua_State* L): mLua(L) {}
+    ~LuaGcPacer();
+
+    LuaGcPacer(const LuaGcPacer&) = delete;
+
+    /**
+     * @param budget time of a single step; the step may exceed it by the duration of one incremental GC step.
+     */
+    void enable(Mode mode, std::chrono::microseconds budget);
+    void disable();
+
+    [[nodiscard]]
+    bool enabled() const noexcept {
+        return mEnabled;
+    }
+
+    /**
+     * @brief Schedules a step after the current frame. Does nothing if disabled or already scheduled.
+     */
+    void frameRendered();
+
+    /**
+     * @brief Performs a budgeted step now.
+     */
+    void step();
+
+    [[nodiscard]]
+    Stats stats() const;
+
+private:
+    struct Pause {
+        Clock::time_point at;
+        std::chrono::microseconds duration;
+    };
+
+    lua_State* mLua;
+    bool mEnabled = false;
+    bool mScheduled = false;
+    bool mGenerational = false;
+    std::chrono::microseconds mBudget{0};
+
+    /**
+     * @brief Heap size at the end of the last cycle (generational mode: of the last full collection), KiB.
+     */
+    int mLiveKb = 0;
+    std::size_t mSteps = 0;
+    std::size_t mCycles = 0;
+    std::deque<Pause> mPauses;
+
+    /**
+     * @brief Expires with the pacer; scheduled steps check it before running.
+     */
+    std::shared_ptr<char> mGuard = std::make_shared<char>();
+
+    void record(Clock::time_point at, std::chrono::microseconds duration);
+
+    /**
+     * @brief Runs a full collection if the heap outgrew twice its live size.
+     * @return whether it did.
+     */
+    bool collectIfFallingBehind();
+};
@@ -0,0 +1,90 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef AUI_LUA_OVERRIDE_PROFILING
+#define AUI_LUA_OVERRIDE_PROFILING 0
+#endif
+
+/**
+ * @brief Timing counters of Lua-dispatched overrides of LuaExposedView (render, getContentMinimumWidth, etc).
+ * @details
+ * The generated overrides time their Lua calls only when built with AUI_LUA_OVERRIDE_PROFILING=1 (CMake option of
+ * the same name); otherwise the counters stay empty and cost nothing. Counters are keyed by the exposed C++ class and
+ * the method name and are updated atomically, so views of different threads may share them.
+ */
+class LuaOverrideProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Counter {
+        std::atomic<std::uint64_t> calls{0};
+        std::atomic<std::uint64_t> totalNs{0};
+        std::atomic<std::uint64_t> maxNs{0};
+
+        void add(std::uint64_t ns) noexcept {
+            calls.fetch_add(1, std::memory_order_relaxed);
+            totalNs.fetch_add(ns, std::memory_order_relaxed);
+            auto max = maxNs.load(std::memory_order_relaxed);
+            while (ns > max && !maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+        }
+    };
+
+    struct Entry {
+        std::string className;
+        std::string method;
+        std::uint64_t calls;
+        std::uint64_t totalNs;
+        std::uint64_t maxNs;
+    };
+
+    /**
+     * @brief Times the enclosing scope into the counter.
+     */
+    class Scope {
+    public:
+        explicit Scope(Counter& counter) noexcept: mCounter(counter), mStart(Clock::now()) {}
+
+        ~Scope() {
+            mCounter.add(std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - mStart).count()));
+        }
+
+        Scope(const Scope&) = delete;
+
+    private:
+        Counter& mCounter;
+        Clock::time_point mStart;
+    };
+
+    /**
+     * @brief Counter of the class' method. The reference stays valid for the lifetime of the process.
+     */
+    static Counter& counter(std::string_view className, std::string_view method);
+
+    /**
+     * @return counters that were called at least once, sorted by total time, descending.
+     */
+    static std::vector<Entry> snapshot();
+
+    /**
+     * @brief snapshot() as a JSON array of {"class", "method", "calls", "totalNs", "maxNs"} objects.
+     */
+    static std::string toJson();
+
+    static void reset();
+};
@@ -0,0 +1,96 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#pragma once
+
+#include <clg.hpp>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Sampling profiler of Lua code, based on lua_sethook.
+ * @details
+ * A count hook checks the clock every instructionCount VM instructions and records the Lua call stack once the
+ * sampling interval has passed. Lua frames are named "function (source:line)"; C frames are named "[C] Class:method"
+ * for bindings named with nameBindings (e.g. "[C] Button:setText"), "[C] name" otherwise, which marks the C++ binding
+ * (setText, setStyle, a signal handler dispatch, ...) that Lua code was called from or that is running. The result is
+ * written in the folded-stack format ("frame;frame;frame count" per line) understood by flamegraph.pl, speedscope and
+ * the like.
+ *
+ * The hook is installed on the profiled state; coroutines created while the profiler runs inherit it. Since count
+ * hooks do not fire while C++ code runs, time spent in bindings is attributed to the Lua code that resumes after them.
+ * A state has a single hook, so only one profiler may run on a state at a time.
+ */
+class LuaProfiler {
+public:
+    explicit LuaProfiler(lua_State* L): mLua(L) {}
+    ~LuaProfiler();
+
+    LuaProfiler(const LuaProfiler&) = delete;
+
+    /**
+     * @throws AException if another profiler is running on the state.
+     */
+    void start(std::chrono::microseconds interval = std::chrono::milliseconds(1), int instructionCount = 1000);
+    void stop();
+
+    [[nodiscard]]
+    bool running() const noexcept {
+        return mRunning;
+    }
+
+    /**
+     * @brief Drops collected samples.
+     */
+    void reset();
+
+    [[nodiscard]]
+    std::size_t sampleCount() const noexcept {
+        return mSampleCount;
+    }
+
+    /**
+     * @brief Collected samples in the folded-stack format, sorted by stack.
+     */
+    [[nodiscard]]
+    std::string folded() const;
+
+    /**
+     * @return false if the file could not be written.
+     */
+    bool writeFolded(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Names C functions of the table on the top of the stack "className:key" in samples taken on the state.
+     * @details
+     * Called where bindings are registered; the names are kept in the registry of the state, keyed by function.
+     */
+    static void nameBindings(lua_State* L, std::string_view className);
+
+    /**
+     * @brief Names the C function on the top of the stack in samples taken on the state.
+     */
+    static void nameBinding(lua_State* L, std::string_view name);
+
+private:
+    lua_State* mLua;
+    bool mRunning = false;
+    std::chrono::steady_clock::duration mInterval{};
+    std::chrono::steady_clock::time_point mNextSample;
+    std::unordered_map<std::string, std::size_t> mStacks;
+    std::size_t mSampleCount = 0;
+
+    static void hook(lua_State* L, lua_Debug* ar);
+    void sample(lua_State* L);
+};
@@ -0,0 +1,117 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#pragma once
+
+#include "clg.hpp"
+#include <AUI/Util/ARaiiHelper.h>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Lua handlers of a single signal of a single view.
+ * @details
+ * Handlers are kept as pinned clg::function refs in a compact vector, so dispatch does not touch Lua tables.
+ *
+ * Removal is O(1) swap-remove, hence handler call order is not preserved after a handler is removed.
+ *
+ * Handlers added while the signal is being dispatched are deferred until the outermost dispatch finishes; handlers
+ * removed during dispatch are marked dead and compacted at the same point.
+ */
+class LuaSignalHandlers {
+public:
+    void add(clg::function handler) {
+        if (mDispatchDepth > 0) {
+            mPending.push_back(std::move(handler));
+            return;
+        }
+        mHandlers.push_back({ std::move(handler) });
+    }
+
+    void clear() {
+        mPending.clear();
+        if (mDispatchDepth > 0) {
+            for (auto& entry : mHandlers) {
+                entry.alive = false;
+            }
+            mHasDead = !mHandlers.empty();
+            return;
+        }
+        mHandlers.clear();
+        mHasDead = false;
+    }
+
+    [[nodiscard]]
+    std::size_t size() const noexcept {
+        std::size_t result = mPending.size();
+        for (const auto& entry : mHandlers) {
+            result += entry.alive ? 1 : 0;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Calls invoke(clg::function&) for each live handler.
+     * @details
+     * When invoke returns true, the handler is removed.
+     */
+    template<typename Invoke>
+    void dispatch(Invoke&& invoke) {
+        ++mDispatchDepth;
+        ARaiiHelper finally = [&] {
+            if (--mDispatchDepth == 0) {
+                flush();
+            }
+        };
+        // mHandlers is neither grown nor shrunk while mDispatchDepth > 0, so indices stay valid.
+        for (std::size_t i = 0; i < mHandlers.size(); ++i) {
+            auto& entry = mHandlers[i];
+            if (!entry.alive) {
+                continue;
+            }
+            if (invoke(entry.function)) {
+                entry.alive = false;
+                mHasDead = true;
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        clg::function function;
+        bool alive = true;
+    };
+
+    std::vector<Entry> mHandlers;
+    std::vector<clg::function> mPending;
+    unsigned mDispatchDepth = 0;
+    bool mHasDead = false;
+
+    void flush() {
+        if (mHasDead) {
+            for (std::size_t i = 0; i < mHandlers.size();) {
+                if (mHandlers[i].alive) {
+                    ++i;
+                    continue;
+                }
+                if (i + 1 != mHandlers.size()) {
+                    std::swap(mHandlers[i], mHandlers.back());
+                }
+                mHandlers.pop_back();
+            }
+            mHasDead = false;
+        }
+        for (auto& handler : mPending) {
+            mHandlers.push_back({ std::move(handler) });
+        }
+        mPending.clear();
+    }
+};
@@ -0,0 +1,53 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#pragma once
+
+#include "lua.h"
+#include <cstdint>
+
+/**
+ * @brief Small vector userdata (vec2, vec3, vec4) used to pass glm vectors to Lua and back.
+ * @details
+ * A vector is a single userdata instead of a table with array part, and is indexed both as an array (v[1], v[2]) and
+ * by component name (v.x, v.y, v.z, v.w). It supports +, -, *, /, // and unary minus with vectors of the same size and
+ * with numbers, ==, #, pairs, ipairs and tostring. Integer // by zero raises an error, as it does for Lua integers.
+ *
+ * Compared to the tables vectors used to be, type(v) is 'userdata' and the raw next(v) does not work (pairs does);
+ * code telling vectors from other values by type(v) == 'table' has to be updated. Tables are still accepted wherever a
+ * vector is expected.
+ *
+ * Vectors converted from integer glm vectors (ivec2 etc.) keep returning integers from their components as long as
+ * arithmetic allows it, so Lua code observes the same values as with tables.
+ */
+class LuaVec {
+public:
+    static constexpr int MAX_SIZE = 4;
+
+    struct Value {
+        lua_Number components[MAX_SIZE] = {};
+        std::uint8_t size = 0;
+        bool integral = false;
+    };
+
+    static void push(lua_State* l, const Value& value);
+
+    /**
+     * @return true if the value at index n is a vector userdata; its contents are written to out.
+     */
+    static bool get(lua_State* l, int n, Value& out);
+
+    /**
+     * @brief Registers vec2, vec3 and vec4 constructor functions as globals.
+     * @details
+     * vecN(x, y, ...) takes N numbers, vecN(s) broadcasts a number, vecN(t) converts a table or another vector.
+     */
+    static void registerConstructors(lua_State* l);
+};
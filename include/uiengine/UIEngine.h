@@ -12,22 +12,171 @@
 
 #include <clg.hpp>
 #include "uiengine/Converters.h"
+#include "uiengine/LuaGcPacer.h"
+#include "uiengine/LuaProfiler.h"
 #include <AUI/View/AViewContainer.h>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
 
+class StyleCache;
+class InvalidationBatch;
+class HotReload;
+
+/**
+ * @brief Lua UI bindings for a surface.
+ * @details
+ * Each UIEngine registers its bindings in its own lua_State and reaches the VM through it only, so independent engines
+ * (plugins, offscreen renderers, tests) may coexist in one process. An engine and its state are to be driven from a
+ * single thread at a time; clg value types (clg::ref, clg::table, ...) resolve the VM with clg::state(), so that
+ * thread's clg::state() has to be the engine's state (i.e., a clg::vm per thread).
+ */
 class UIEngine {
 public:
-    UIEngine(AViewContainer& surface);
+    /**
+     * @param lua state to register the bindings in and to run forms with. Defaults to the current clg::state().
+     */
+    explicit UIEngine(AViewContainer& surface, lua_State* lua = clg::state());
 
     UIEngine(const UIEngine&) = delete;
 
+    ~UIEngine();
+
+    /**
+     * @brief Runs a Lua form file.
+     * @param file path relative to the forms root (see setFormsRoot).
+     * @return view returned by the form chunk; nullptr if it returned nothing or failed to load.
+     * @details
+     * When a bytecode cache directory is set, the compiled chunk is stored there and loaded on subsequent calls
+     * instead of parsing the source, as long as the source did not change.
+     */
     _<AView> loadForm(std::string_view file);
 
+    /**
+     * @brief Asynchronous loadForm: the file is read and compiled on a worker thread, then the chunk is run on the UI
+     * thread, so the UI keeps rendering (a splash screen, for instance) while a large form is being prepared.
+     * @param onLoaded called on the UI thread with the view returned by the form chunk; nullptr if it returned nothing
+     * or failed to load. Not called if the UIEngine is destroyed before the form is compiled.
+     */
+    void loadFormAsync(std::string_view file, std::function<void(_<AView>)> onLoaded);
+
+    /**
+     * @brief Compiles the source on a worker thread and runs it on the UI thread.
+     * @param chunkName chunk name for error messages and stack traces, as in luaL_loadbuffer.
+     * @param onLoaded see loadFormAsync.
+     */
+    void runAsync(std::string source, std::string chunkName, std::function<void(_<AView>)> onLoaded = {});
+
+    /**
+     * @brief Watches the files of forms loaded with loadForm (after this call) and reloads them when they change.
+     * @details
+     * A changed form is run again; the views it produces are reconciled with the live ones instead of replacing the
+     * whole tree, so unchanged views keep their state (typed text, geometry, focus) and only differing styles are
+     * reapplied. UI.setSurface called by the reloaded form reconciles with the current surface contents as well.
+     * Views with Lua signal handlers, fields or overrides are always replaced. Enabling hot reload turns structural
+     * style hashing on (see UI.setStyleStructuralHashing). Intended for development builds.
+     * @param pollInterval how often modification times of the files are checked.
+     */
+    void setHotReload(bool enabled, std::chrono::milliseconds pollInterval = std::chrono::milliseconds(250));
+
+    /**
+     * @brief Reloads a form loaded with loadForm while hot reload is enabled, as if its file changed.
+     * @return false if the form is not watched or failed to run.
+     */
+    bool reloadForm(std::string_view file);
+
+    /**
+     * @brief Directory loadForm resolves form paths against. Default is "ui".
+     */
+    void setFormsRoot(APath formsRoot) {
+        mFormsRoot = std::move(formsRoot);
+    }
+
+    /**
+     * @brief Directory for the bytecode of forms loaded with loadForm. Empty path (default) disables the cache.
+     */
+    void setBytecodeCacheDir(APath bytecodeCacheDir) {
+        mBytecodeCacheDir = std::move(bytecodeCacheDir);
+    }
+
+
+    /**
+     * @brief Counters of style property interning in rule constructors (BackgroundSolid(...), Padding(...), etc).
+     */
+    struct RuleInterningStats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+    };
+
+    [[nodiscard]]
+    RuleInterningStats& ruleInterningStats() noexcept {
+        return mRuleInterningStats;
+    }
+
+    /**
+     * @brief Counters of memoized Lua min size overrides (see ILuaExposedView::setMinSizeMemoization).
+     */
+    struct MinSizeMemoStats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+    };
+
+    [[nodiscard]]
+    MinSizeMemoStats& minSizeMemoStats() noexcept {
+        return mMinSizeMemoStats;
+    }
+
+    /**
+     * @brief Cache of compiled setStyle tables.
+     */
+    [[nodiscard]]
+    StyleCache& styleCache() const noexcept {
+        return *mStyleCache;
+    }
+
+    /**
+     * @brief View tree invalidations of the container bindings; deferred within UI.batch.
+     */
+    [[nodiscard]]
+    InvalidationBatch& invalidationBatch() const noexcept {
+        return *mInvalidationBatch;
+    }
+
+    /**
+     * @brief Frame-budgeted garbage collection of the engine's state; disabled by default.
+     */
+    [[nodiscard]]
+    LuaGcPacer& gcPacer() noexcept {
+        return mGcPacer;
+    }
+
+    /**
+     * @brief Sampling profiler of the engine's state; also available to Lua as the Profiler table.
+     */
+    [[nodiscard]]
+    LuaProfiler& profiler() noexcept {
+        return mProfiler;
+    }
 
     [[nodiscard]]
     AViewContainer& surface() const noexcept {
         return mSurface;
     }
 
+    [[nodiscard]]
+    lua_State* luaState() const noexcept {
+        return mLua;
+    }
+
+    /**
+     * @brief SIGNAL_REMOVE value of this engine's state; returning it from a signal handler disconnects the handler.
+     */
+    [[nodiscard]]
+    const clg::ref& signalRemove() const noexcept {
+        return mSignalRemove;
+    }
+
     static const char* anyToString(const clg::ref& r); // для lldb.py
     static const char* anyToString(lua_State* L, int n = -1); // для lldb.py
 
@@ -44,16 +193,48 @@ public:
      */
     static std::string clgDump(clg::ref any);
 
-    static clg::table_view luaChildrenTable(const _<AViewContainer>& cont);
-
+    /**
+     * @brief Keeps the Lua object of a child alive while it is in the container (see ILuaExposedView::anchorChildren).
+     */
     static void addChild(const _<AViewContainer>& cont, const _<AView>& view);
 
     static void removeChild(const _<AViewContainer>& cont, const _<AView>& view);
 
+    static void addChildren(const _<AViewContainer>& cont, const AVector<_<AView>>& views);
+
+    static void removeChildren(const _<AViewContainer>& cont, const AVector<_<AView>>& views);
+
     static void removeAllChildren(const _<AViewContainer>& cont);
 
     _<AView> wrapViewWithLuaWrapper(const _<AView>& v);
 
 private:
+    friend class HotReload;
+
     AViewContainer& mSurface;
+    lua_State* mLua;
+    clg::ref mSignalRemove;
+    LuaGcPacer mGcPacer;
+    LuaProfiler mProfiler;
+    APath mFormsRoot = "ui";
+    APath mBytecodeCacheDir;
+    std::unique_ptr<StyleCache> mStyleCache;
+    std::unique_ptr<InvalidationBatch> mInvalidationBatch;
+    std::unique_ptr<HotReload> mHotReload;
+    RuleInterningStats mRuleInterningStats;
+    MinSizeMemoStats mMinSizeMemoStats;
+
+    /**
+     * @brief Expires with the UIEngine; asynchronous loads check it before touching the engine.
+     */
+    std::shared_ptr<char> mAsyncGuard = std::make_shared<char>();
+
+    /**
+     * @brief Runs the chunk on top of the stack, popping it.
+     * @return view returned by the chunk; nullptr if it returned nothing or failed.
+     */
+    _<AView> runForm(lua_State* L, const AString& name);
+
+    void compileAsync(std::function<std::string()> compile, std::string chunkName, AString name,
+                      std::function<void(_<AView>)> onLoaded);
 };
\ No newline at end of file
@@ -19,6 +19,28 @@ RE_CLASS_DEF = re.compile(r'^\s*(class|struct) (\w+)')
 RE_METHOD_DEF = re.compile(r'^\s*(\S+) (\S+)\((.+ [a-zA-Z0-9]+)*\)( const)? override;')
 RE_BLOCK_END = re.compile(r'^\s*}\s*;')
 
+# overrides whose results may be memoized until markMinContentSizeInvalid (see ILuaExposedView::setMinSizeMemoization)
+MIN_SIZE_QUERIES = {
+    'getContentMinimumWidth': 'CONTENT_WIDTH',
+    'getContentMinimumHeight': 'CONTENT_HEIGHT',
+    'getMinimumWidth': 'WIDTH',
+    'getMinimumHeight': 'HEIGHT',
+}
+
+FNV_OFFSET_BASIS = 0x811c9dc5
+FNV_PRIME = 0x01000193
+
+
+def fnv1a(name):
+    """
+    32-bit FNV-1a; must match luaVirtualFuncHash emitted into the generated class.
+    """
+    h = FNV_OFFSET_BASIS
+    for c in name.encode('utf-8'):
+        h ^= c
+        h = (h * FNV_PRIME) & 0xffffffff
+    return h
+
 
 def parse_argument(argument):
     RE_ARGUMENT = re.compile(r'(.*) ([a-zA-Z0-9]+)')
@@ -72,25 +94,42 @@ class Parser:
                     self.methods = []
 
                     def visit_block_end(match):
-                        output.write("\nprivate:\n")
-
+                        hashes = {}
+                        for method in self.methods:
+                            h = fnv1a(method)
+                            if h in hashes:
+                                raise RuntimeError(f"lua_reflection: hash collision between {hashes[h]} and {method}")
+                            hashes[h] = method
+
+                        output.write("\nprotected:\n")
+                        output.write("void handle_lua_virtual_func_assignment(std::string_view name, clg::ref value) override {\n")
+                        output.write("    _<clg::function>* slot = nullptr;\n")
+                        output.write("    switch (luaVirtualFuncHash(name)) {\n")
                         for method in self.methods:
-                            output.write(f"bool m_{method}Flag = false;\n")
+                            output.write(f'        case {fnv1a(method):#010x}u: if (name == "{method}") slot = &m_{method}Func; break;\n')
+                        output.write("        default: return;\n")
+                        output.write("    }\n")
+                        output.write("    if (!slot) return;\n")
+                        output.write("    if (auto func = value.template is<clg::function>()) {\n")
+                        output.write("        *slot = _new<clg::function>(std::move(*func));\n")
+                        output.write("    } else {\n")
+                        output.write("        slot->reset();\n")
+                        output.write("    }\n")
+                        output.write("    this->invalidateMinSizeMemo();\n")
+                        output.write("}\n")
+
+                        output.write("\nprivate:\n")
 
-                        output.write("static const std::map<std::string_view, bool(LuaExposedView::*)>& ")
-                        output.write(f"vtable()")
-                        output.write(" {\n")
-                        output.write("    static const std::map<std::string_view, bool(LuaExposedView::*)> v = {\n")
                         for method in self.methods:
-                            output.write("        { ")
-                            output.write("\"")
-                            output.write(method)
-                            output.write("\", ")
-                            output.write(f"&LuaExposedView::m_{method}Flag")
-                            output.write(" },\n")
-
-                        output.write("    };\n")
-                        output.write("    return v;\n")
+                            output.write(f"_<clg::function> m_{method}Func;\n")
+
+                        output.write("static constexpr std::uint32_t luaVirtualFuncHash(std::string_view name) noexcept {\n")
+                        output.write(f"    std::uint32_t hash = {FNV_OFFSET_BASIS:#010x}u;\n")
+                        output.write("    for (char c : name) {\n")
+                        output.write("        hash ^= std::uint8_t(c);\n")
+                        output.write(f"        hash *= {FNV_PRIME:#010x}u;\n")
+                        output.write("    }\n")
+                        output.write("    return hash;\n")
                         output.write("}\n")
                         self.output.write("};\n")
                         self.blockEnd = True
@@ -115,7 +154,8 @@ class Parser:
                         output.write(') override {\n')
 
                         if name == "render":
-                            output.write("performance::AUI_VIEW_RENDER += 1;\n")
+                            output.write("  performance::AUI_VIEW_RENDER.fetch_add(1, std::memory_order_relaxed);\n")
+                            output.write("  this->luaFrameRendered();\n")
 
 
                         def createSuperCall():
@@ -132,16 +172,31 @@ class Parser:
                             output.write(argNames)
                             output.write(');\n')
 
+                        memoQuery = MIN_SIZE_QUERIES.get(name)
+                        if memoQuery:
+                            output.write(f'  if (m_{name}Func) {{\n')
+                            output.write(f'      if (auto memoized = this->memoizedMinSize(ILuaExposedView::MinSizeQuery::{memoQuery})) {{\n')
+                            output.write('          return *memoized;\n')
+                            output.write('      }\n')
+                            output.write('  }\n')
+
                         output.write('  ')
                         if isVoid:
                             createSuperCall()
-                            output.write(f'     if (!m_{name}Flag) return;\n')
                         else:
                             createSuperCallWithResult()
-                            output.write(f'     if (!m_{name}Flag) return superCallResult;\n')
 
-                        output.write(f'     if (auto func = luaDataHolder()["{name}"].template is<clg::function>())\n')
+                        if name == "render":
+                            output.write("  this->luaRenderCanvas(context.render);\n")
+
+                        output.write(f'     if (const auto& func = m_{name}Func)\n')
                         output.write('      {\n')
+                        output.write('#if AUI_LUA_OVERRIDE_PROFILING\n')
+                        output.write(f'      static auto& luaProfilingCounter = LuaOverrideProfiler::counter(AClass<View>::name().toStdString(), "{name}");\n')
+                        output.write('      LuaOverrideProfiler::Scope luaProfilingScope(luaProfilingCounter);\n')
+                        output.write('#endif\n')
+                        if any('Event' in parse_argument(i)[0] for i in args):
+                            output.write('      LuaEventDispatch luaEventDispatch;\n')
 
                         if not argNames:
                             argsNamesWithComma = ""
@@ -150,8 +205,10 @@ class Parser:
 
                         if isVoid:
                             try_catch_wrapper(f'            (*func)(aui::ptr::shared_from_this(this){argsNamesWithComma});\n')
+                        elif memoQuery:
+                            try_catch_wrapper(f'            return this->memoizeMinSize(ILuaExposedView::MinSizeQuery::{memoQuery}, func->template call<{returnType}>(aui::ptr::shared_from_this(this){argsNamesWithComma}));\n')
                         else:
-                            try_catch_wrapper(f'            return (*func).template call<{returnType}>(aui::ptr::shared_from_this(this){argsNamesWithComma});\n')
+                            try_catch_wrapper(f'            return func->template call<{returnType}>(aui::ptr::shared_from_this(this){argsNamesWithComma});\n')
                         output.write('    }\n')
 
                         if not isVoid:
@@ -11,19 +11,29 @@
 #pragma once
 
 
+#include <atomic>
+#include <cstdint>
+#include <string_view>
 #include "AUI/Render/ARenderContext.h"
 #include <AUI/View/AView.h>
 #include <uiengine/ILuaExposedView.h>
+#include <uiengine/LuaEvent.h>
+#include <uiengine/LuaOverrideProfiler.h>
 
 namespace performance {
-    extern unsigned AUI_VIEW_RENDER;
+    /**
+     * @brief Number of render calls of all LuaExposedViews, of all engines and threads.
+     */
+    extern std::atomic<unsigned> AUI_VIEW_RENDER;
 }
 
 template<typename View>
 class LuaExposedView: public View, public ILuaExposedView {
 public:
     template<typename... Args>
-    LuaExposedView(UIEngine& uiEngine, Args&&... args): View(std::forward<Args>(args)...), ILuaExposedView(uiEngine) {}
+    LuaExposedView(UIEngine& uiEngine, Args&&... args): View(std::forward<Args>(args)...), ILuaExposedView(uiEngine) {
+        bindExposedClass(static_cast<View*>(this), typeid(LuaExposedView));
+    }
     ~LuaExposedView() override {
 
     }
@@ -61,11 +71,9 @@ public:
     void setGeometry(int x, int y, int width, int height) override;
     AMenuModel composeContextMenu() override { return {}; }
 
-protected:
-    void handle_lua_virtual_func_assignment(std::string_view name, clg::ref value) override {
-        if (auto it = vtable().find(name); it != vtable().end()) {
-            (this->*(it->second)) = !value.isNull();
-        }
+    void markMinContentSizeInvalid() override {
+        invalidateMinSizeMemo();
+        View::markMinContentSizeInvalid();
     }
 
 private:
@@ -14,10 +14,12 @@
 #include "AUI/Common/AException.h"
 #include "AUI/Traits/concepts.h"
 #include "StyleHelper.h"
+#include "StyleCache.h"
 #include "Animator.h"
 #include <AUI/Platform/AWindow.h>
 #include <AUI/Animator/AAnimator.h>
 #include "SignalHelpers.h"
+#include "InvalidationBatch.h"
 #include "clg.hpp"
 
 using namespace ass;
@@ -30,8 +32,36 @@ namespace clg {
 }
 
 
+static _<AViewContainer> asContainer(const _<AView>& view) {
+    if (auto lua = ILuaExposedView::fromView(view.get())) {
+        if (auto container = lua->container()) {
+            return std::shared_ptr<AViewContainer>(view, container);
+        }
+        return nullptr;
+    }
+    return _cast<AViewContainer>(view);
+}
+
+static _<AViewContainerBase> asContainerBase(const _<AView>& view) {
+    if (auto lua = ILuaExposedView::fromView(view.get())) {
+        if (auto container = lua->containerBase()) {
+            return std::shared_ptr<AViewContainerBase>(view, container);
+        }
+        return nullptr;
+    }
+    return _cast<AViewContainerBase>(view);
+}
+
+static void checkViews(const AVector<_<AView>>& views, const char* method) {
+    for (size_t i = 0; i < views.size(); ++i) {
+        if (views[i] == nullptr) {
+            throw AException("{}: item {} is not a view"_format(method, i + 1));
+        }
+    }
+}
+
 static std::optional<std::tuple<int, _<AView>>> containerIterator(_<AView> view, int iterator) {
-    if (auto c = _cast<AViewContainer>(view)) {
+    if (auto c = asContainer(view)) {
         if (iterator < c->getViews().size()) {
             return std::make_optional(std::make_tuple(iterator + 1, c->getViews()[iterator]));
         }
@@ -52,7 +82,7 @@ struct ForwardSignalAndEmit {
 
 
 ExposeHelper::ExposeHelper(UIEngine& uiEngine): mUiEngine(uiEngine)  {
-    clg::state_interface(clg::state()).register_function<containerIterator>("__uiengine_container_iter");
+    clg::state_interface(state()).register_function<containerIterator>("__uiengine_container_iter");
     auto setCursor = [] (const _<AView>& self, const clg::ref& image, int size = 16) {
         if (image.isNull()) {
             if (auto parent = self->getParent()) {
@@ -68,7 +98,7 @@ ExposeHelper::ExposeHelper(UIEngine& uiEngine): mUiEngine(uiEngine)  {
         return clg::builder_return_type{};
     };
 
-    clg::state_interface(clg::state()).register_class<AView>()
+    clg::state_interface(state()).register_class<AView>()
             .method("geometryChanged", ForwardSignal<&AView::geometryChanged>())
             .method("positionChanged", ForwardSignalAndEmit<&AView::position>{[](const _<AView>& view, const clg::function& callback) {
                 callback(view, view->getPosition());
@@ -105,97 +135,150 @@ ExposeHelper::ExposeHelper(UIEngine& uiEngine): mUiEngine(uiEngine)  {
                 self->focus(true);
                 return clg::builder_return_type{};
             })
-            .method("setStyle", [&](const _<AView>& view, clg::table table) {
+            .method("setStyle", [&uiEngine = mUiEngine](const _<AView>& view, const clg::ref& table) {
                 if (!view) {
                     return clg::builder_return_type{};
                 }
-                if (table.empty()) {
+                auto luaView = ILuaExposedView::fromView(view.get());
+                if (uiEngine.styleCache().isEmpty(table)) {
                     view->setCustomStyle({});
                     view->setExtraStylesheet(nullptr);
+                    AUI_NULLSAFE(luaView)->setAppliedStyle(nullptr);
                     return clg::builder_return_type{};
                 }
-                StyleHelper sh;
-                if (!sh.processDeclaration(table)) {
-                    PropertyListRecursive ruleWithoutSelector;
-                    StyleHelper::processDeclarations(ruleWithoutSelector, table.toArray());
-                    view->setCustomStyle(std::move(ruleWithoutSelector));
-                    return clg::builder_return_type{};
+                auto compiled = uiEngine.styleCache().get(table);
+                if (compiled->stylesheet) {
+                    view->setExtraStylesheet(compiled->stylesheet);
+                } else {
+                    view->setCustomStyle(compiled->customStyle);
                 }
-
-                auto stylesheet = _new<AStylesheet>(AStylesheet(std::initializer_list<Rule>{}));
-                stylesheet->setRules(std::move(static_cast<AVector<Rule>&>(sh.rules())));
-                view->setExtraStylesheet(std::move(stylesheet));
-
+                AUI_NULLSAFE(luaView)->setAppliedStyle(compiled);
                 return clg::builder_return_type{};
             })
             .builder_method<&AView::setEnabled>("setEnabled")
             .builder_method<&AView::setVisibility>("setVisibility")
-            .method("inflateView", [&] (const _<AView>& self, const _<AView>& wrapped) {
-                if (auto c = _cast<AViewContainer>(self)) {
+            .method("inflateView", [&uiEngine = mUiEngine] (const _<AView>& self, const _<AView>& wrapped) {
+                if (auto c = asContainer(self)) {
                     ALayoutInflater::inflate(*c, wrapped);
-                    c->markMinContentSizeInvalid();
+                    uiEngine.invalidationBatch().minContentSizeChanged(c);
                 }
                 return clg::builder_return_type{};
             })
-            .method("removeAllViews", [] (const _<AView>& self) {
-                if (auto c = _cast<AViewContainer>(self)) {
+            .method("removeAllViews", [&uiEngine = mUiEngine] (const _<AView>& self) {
+                if (auto c = asContainer(self)) {
                     c->removeAllViews();
-                    c->markMinContentSizeInvalid();
+                    uiEngine.invalidationBatch().minContentSizeChanged(c);
                     UIEngine::removeAllChildren(c);
                 }
                 return clg::builder_return_type{};
             })
-            .method("addViewCustomLayout", [] (const _<AView>& self, const _<AView>& view) {
-                if (auto c = _cast<AViewContainer>(self)) {
+            .method("addViewCustomLayout", [&uiEngine = mUiEngine] (const _<AView>& self, const _<AView>& view) {
+                if (auto c = asContainer(self)) {
                     c->addViewCustomLayout(view);
                     UIEngine::addChild(c, view);
-                    self->invalidateAssHelper();
-                    if(c->getParent()) c->applyGeometryToChildrenIfNecessary();
-                    c->markMinContentSizeInvalid();
+                    uiEngine.invalidationBatch().styleChanged(self);
+                    uiEngine.invalidationBatch().geometryChanged(c);
+                    uiEngine.invalidationBatch().minContentSizeChanged(c);
                 }
                 return clg::builder_return_type{};
             })
-            .method("addView", [] (const _<AView>& self, const _<AView>& view) {
+            .method("addView", [&uiEngine = mUiEngine] (const _<AView>& self, const _<AView>& view) {
                 if (view == nullptr) {
                     throw AException("addView(nil)?");
                 }
-                if (auto c = _cast<AViewContainer>(self)) {
+                if (auto c = asContainer(self)) {
                     c->addView(view);
                     UIEngine::addChild(c, view);
-                    c->markMinContentSizeInvalid();
+                    uiEngine.invalidationBatch().minContentSizeChanged(c);
                 } else {
                     throw AException("addView() called on non-container type");
                 }
                 return clg::builder_return_type{};
             })
-            .method("addViewAtIndex", [](const _<AView>& self, const _<AView>& view, size_t index) {
-                if (auto c = _cast<AViewContainer>(self)) {
+            .method("addViewAtIndex", [&uiEngine = mUiEngine](const _<AView>& self, const _<AView>& view, size_t index) {
+                if (auto c = asContainer(self)) {
                     if (index > c->getViews().size()) {
                         throw AException("addViewAtIndex: index cannot be larger than container size");
                     }
                     c->addView(index, view);
                     UIEngine::addChild(c, view);
-                    c->markMinContentSizeInvalid();
+                    uiEngine.invalidationBatch().minContentSizeChanged(c);
                 } else {
                     throw AException("addViewAtIndex() called on non-container type");
                 }
                 return clg::builder_return_type{};
             })
-            .method("removeViewAtIndex", [](const _<AView>& self, size_t index) {
-                if (auto c = _cast<AViewContainer>(self)) {
+            .method("removeViewAtIndex", [&uiEngine = mUiEngine](const _<AView>& self, size_t index) {
+                if (auto c = asContainer(self)) {
                     if (index == 0 || index > c->getViews().size()) {
                         throw AException("removeViewAtIndex: index cannot be larger than container size");
                     }
                     UIEngine::removeChild(c, c->getViews()[index - 1]);
                     c->removeView(index - 1);
-                    c->markMinContentSizeInvalid();
+                    uiEngine.invalidationBatch().minContentSizeChanged(c);
                 } else {
                     throw AException("removeViewAtIndex() called on non-container type");
                 }
                 return clg::builder_return_type{};
             })
+            .method("addViews", [&uiEngine = mUiEngine](const _<AView>& self, const AVector<_<AView>>& views) {
+                auto c = asContainer(self);
+                if (!c) {
+                    throw AException("addViews() called on non-container type");
+                }
+                checkViews(views, "addViews");
+                c->addViews(views);
+                UIEngine::addChildren(c, views);
+                uiEngine.invalidationBatch().minContentSizeChanged(c);
+                return clg::builder_return_type{};
+            })
+            .method("insertViews", [&uiEngine = mUiEngine](const _<AView>& self, size_t index, const AVector<_<AView>>& views) {
+                auto c = asContainer(self);
+                if (!c) {
+                    throw AException("insertViews() called on non-container type");
+                }
+                if (index == 0 || index > c->getViews().size() + 1) {
+                    throw AException("insertViews: index {} is out of bounds"_format(index));
+                }
+                checkViews(views, "insertViews");
+                for (size_t i = 0; i < views.size(); ++i) {
+                    c->addView(index - 1 + i, views[i]);
+                }
+                UIEngine::addChildren(c, views);
+                uiEngine.invalidationBatch().minContentSizeChanged(c);
+                return clg::builder_return_type{};
+            })
+            .method("removeViews", [&uiEngine = mUiEngine](const _<AView>& self, size_t from, size_t to) {
+                auto c = asContainer(self);
+                if (!c) {
+                    throw AException("removeViews() called on non-container type");
+                }
+                if (from == 0 || to < from || to > c->getViews().size()) {
+                    throw AException("removeViews: range [{}, {}] is out of bounds"_format(from, to));
+                }
+                AVector<_<AView>> removed(c->getViews().begin() + (from - 1), c->getViews().begin() + to);
+                for (auto i = to; i-- > from - 1;) {
+                    c->removeView(i);
+                }
+                UIEngine::removeChildren(c, removed);
+                uiEngine.invalidationBatch().minContentSizeChanged(c);
+                return clg::builder_return_type{};
+            })
+            .method("replaceChildren", [&uiEngine = mUiEngine](const _<AView>& self, const AVector<_<AView>>& views) {
+                auto c = asContainer(self);
+                if (!c) {
+                    throw AException("replaceChildren() called on non-container type");
+                }
+                checkViews(views, "replaceChildren");
+                c->removeAllViews();
+                UIEngine::removeAllChildren(c);
+                c->addViews(views);
+                UIEngine::addChildren(c, views);
+                uiEngine.invalidationBatch().minContentSizeChanged(c);
+                return clg::builder_return_type{};
+            })
             .method("getViewAtIndex", [](const _<AView>& self, size_t index) -> _<AView> {
-                if (auto c = _cast<AViewContainerBase>(self)) {
+                if (auto c = asContainerBase(self)) {
                     auto& views = c->getViews();
                     if (index == 0 || index > views.size()) {
                         return nullptr;
@@ -205,7 +288,7 @@ ExposeHelper::ExposeHelper(UIEngine& uiEngine): mUiEngine(uiEngine)  {
                 return nullptr;
             })
             .method("size", [](const _<AView>& self) -> std::optional<size_t> {
-                if (auto c = _cast<AViewContainerBase>(self)) {
+                if (auto c = asContainerBase(self)) {
                     return c->getViews().size();
                 }
                 return std::nullopt;
@@ -218,13 +301,13 @@ ExposeHelper::ExposeHelper(UIEngine& uiEngine): mUiEngine(uiEngine)  {
                 return {};
             })
             .method("getViews", [] (const _<AView>& self) {
-                if (auto c = _cast<AViewContainerBase>(self)) {
+                if (auto c = asContainerBase(self)) {
                     return c->getViews();
                 }
                 return AVector<_<AView>>{};
             })
             .method("visitViewsRecursive", [](const _<AView>& self, const clg::function& callback) {
-                if (auto c = _cast<AViewContainerBase>(self)) {
+                if (auto c = asContainerBase(self)) {
                     c->visitsViewRecursive([&](const _<AView>& view){
                         callback(view);
                         return false;
@@ -234,7 +317,7 @@ ExposeHelper::ExposeHelper(UIEngine& uiEngine): mUiEngine(uiEngine)  {
             })
             .method("updateLayout", [] (const _<AView>& self) {
                 APerformanceSection updateLayout("layout update");
-                if (auto c = _cast<AViewContainerBase>(self)) {
+                if (auto c = asContainerBase(self)) {
                     c->applyGeometryToChildrenIfNecessary();
                 }
                 return clg::builder_return_type{};
@@ -244,8 +327,8 @@ ExposeHelper::ExposeHelper(UIEngine& uiEngine): mUiEngine(uiEngine)  {
             })
             .method("visitViewsUnderPos", [] (const _<AView>& self, glm::ivec2 pos, const clg::function& callback) {
                 return self->getWindow()->getViewAtRecursive(pos, [&](const _<AView>& v){
-                    if (auto c = _cast<ILuaExposedView>(v)) {
-                        if (callback.call<bool>(c)) {
+                    if (auto lua = ILuaExposedView::fromView(v.get())) {
+                        if (callback.call<bool>(std::shared_ptr<ILuaExposedView>(v, lua))) {
                             return true;
                         }
                     }
@@ -256,14 +339,14 @@ ExposeHelper::ExposeHelper(UIEngine& uiEngine): mUiEngine(uiEngine)  {
             .method("getViewAt", [] (const _<AView>& self, glm::ivec2 pos) {
                 return self->getWindow()->getViewAt(pos);
             })
-            .method("removeView", [] (const _<AView>& self, const _<AView>& view) {
+            .method("removeView", [&uiEngine = mUiEngine] (const _<AView>& self, const _<AView>& view) {
                 if (!view) {
                     return clg::builder_return_type{};
                 }
-                if (auto c = _cast<AViewContainer>(self)) {
+                if (auto c = asContainer(self)) {
                     c->removeView(view);
                     UIEngine::removeChild(c, view);
-                    c->markMinContentSizeInvalid();
+                    uiEngine.invalidationBatch().minContentSizeChanged(c);
                 } else {
                     throw AException("removeView() called on non-container type");
                 }
@@ -277,6 +360,21 @@ ExposeHelper::ExposeHelper(UIEngine& uiEngine): mUiEngine(uiEngine)  {
                 return std::make_tuple(position.x, position.y);
              })
             .builder_method<&AView::setSize>("setSize")
+            .method("setMinSizeMemoization", [](const _<AView>& self, bool enabled) {
+                AUI_NULLSAFE(ILuaExposedView::fromView(self.get()))->setMinSizeMemoization(enabled);
+                return clg::builder_return_type{};
+            })
+            .method("setDraw", [](const _<AView>& self, const clg::ref& draw) {
+                AUI_NULLSAFE(ILuaExposedView::fromView(self.get()))->setDraw(draw);
+                return clg::builder_return_type{};
+            })
+            .method("invalidateDraw", [](const _<AView>& self) {
+                AUI_NULLSAFE(ILuaExposedView::fromView(self.get()))->invalidateDraw();
+            })
+            .method("invalidate", [](const _<AView>& self) {
+                // also drops memoized min sizes, see LuaExposedView::markMinContentSizeInvalid
+                self->markMinContentSizeInvalid();
+            })
             .method("enableRenderToTexture", [](const _<AView>& self) {
                 IRenderViewToTexture::enableForView(AWindow::current()->getRenderingContext()->renderer(), *self);
             })
@@ -300,7 +398,7 @@ ExposeHelper::ExposeHelper(UIEngine& uiEngine): mUiEngine(uiEngine)  {
                 return clg::builder_return_type{};
             })
             .method("dump", [](const _<AView>& self) {
-                if (auto l = dynamic_cast<ILuaExposedView*>(self.get())) {
+                if (auto l = ILuaExposedView::fromView(self.get())) {
                     ALogger::info("Lua") << "dump(): " << l->luaDataHolder().debug_str();
                 }
                 return clg::builder_return_type{};
@@ -313,8 +411,8 @@ ExposeHelper::ExposeHelper(UIEngine& uiEngine): mUiEngine(uiEngine)  {
                 setCursor(self, image);
                 return clg::builder_return_type{};
             })
-            .method("iter", [&](const _<AView>& self) {
-                return std::make_tuple(clg::state_interface(clg::state()).global_variable("__uiengine_container_iter"), self, 0);
+            .method("iter", [&uiEngine = mUiEngine](const _<AView>& self) {
+                return std::make_tuple(clg::state_interface(uiEngine.luaState()).global_variable("__uiengine_container_iter"), self, 0);
             })
             .method("setAnimator", [&](const _<AView>& self, const std::shared_ptr<Animator>& animator) {
                 self->setAnimator(animator->getAuiAnimator());
@@ -324,7 +422,3 @@ ExposeHelper::ExposeHelper(UIEngine& uiEngine): mUiEngine(uiEngine)  {
 
 
 }
-
-lua_State* ExposeHelper::state() {
-    return clg::state();
-}
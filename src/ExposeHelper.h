@@ -23,7 +23,9 @@ struct ExposeHelper {
 public:
     ExposeHelper(UIEngine& uiEngine);
 
-    static lua_State* state();
+    lua_State* state() const noexcept {
+        return mUiEngine.luaState();
+    }
 
 
     template<typename View>
@@ -34,7 +36,7 @@ public:
     template<typename Rule, bool asEnum = std::is_enum_v<Rule>>
     std::conditional_t<asEnum, void, RuleExposer<Rule>> rule(std::string name = clg::class_name<Rule>()) {
         if constexpr (asEnum) {
-            clg::state_interface(clg::state()).register_enum<Rule>(name.c_str(), [](Rule r) -> std::shared_ptr<ass::prop::IPropertyBase> {
+            clg::state_interface(mUiEngine.luaState()).register_enum<Rule>(name.c_str(), [](Rule r) -> std::shared_ptr<ass::prop::IPropertyBase> {
                 return std::make_shared<ass::prop::Property<Rule>>(r);
             });
         } else {
@@ -46,7 +48,7 @@ public:
     void container(std::string_view name) {
         static constexpr auto isLayout = std::is_base_of_v<ALayout, LayoutOrContainer>;
 
-        clg::state_interface(clg::state()).register_function(std::string(name), [&uiEngine = mUiEngine](clg::vararg args) {
+        clg::state_interface(mUiEngine.luaState()).register_function(std::string(name), [&uiEngine = mUiEngine](clg::vararg args) {
             _<AViewContainer> viewContainer;
 
             if constexpr (isLayout) {
@@ -58,8 +60,8 @@ public:
 
             {
                 // for data holder initializating
-                clg::push_to_lua(clg::state(), viewContainer);
-                clg::pop_from_lua<decltype(viewContainer)>(clg::state());
+                clg::push_to_lua(uiEngine.luaState(), viewContainer);
+                clg::pop_from_lua<decltype(viewContainer)>(uiEngine.luaState());
             }
 
             viewContainer->addAssName("ViewContainer");
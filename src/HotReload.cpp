@@ -0,0 +1,308 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include "HotReload.h"
+#include "InvalidationBatch.h"
+#include "LuaChunkLoader.h"
+#include "StyleCache.h"
+#include "View/MyTextArea.h"
+#include "View/MyTextField.h"
+#include <uiengine/ILuaExposedView.h>
+#include <uiengine/UIEngine.h>
+#include <AUI/Common/AException.h>
+#include <AUI/Layout/AAdvancedGridLayout.h>
+#include <AUI/Logging/ALogger.h>
+#include <AUI/Util/ALayoutInflater.h>
+#include <AUI/Util/ARaiiHelper.h>
+#include <AUI/View/AAbstractLabel.h>
+#include <deque>
+#include <typeinfo>
+#include <vector>
+
+static constexpr auto LOG_TAG = "HotReload";
+
+namespace {
+    bool sameKind(const AView& a, const AView& b) {
+        if (typeid(a) != typeid(b) || a.getAssNames() != b.getAssNames()) {
+            return false;
+        }
+        auto ca = dynamic_cast<const AViewContainer*>(&a);
+        auto cb = dynamic_cast<const AViewContainer*>(&b);
+        if (ca == nullptr || cb == nullptr) {
+            return ca == cb;
+        }
+        const auto& la = ca->getLayout();
+        const auto& lb = cb->getLayout();
+        if (!la || !lb) {
+            return la == lb;
+        }
+        return typeid(*la) == typeid(*lb);
+    }
+
+    /**
+     * @brief Key of sameKind, used to pair children of reconciled containers.
+     */
+    std::string kindKey(const AView& view) {
+        std::string result = typeid(view).name();
+        for (const auto& name : view.getAssNames()) {
+            result += ' ';
+            result += name.toStdString();
+        }
+        return result;
+    }
+
+    bool isPlainContainer(ILuaExposedView& view) {
+        if (!view.exposedAs<AViewContainer>()) {
+            return false;
+        }
+        // grid layouts carry their dimensions, which are not compared
+        const auto& layout = view.container()->getLayout();
+        return layout && typeid(*layout) != typeid(AAdvancedGridLayout);
+    }
+
+    /**
+     * @brief Whether a leaf of the same kind may be kept in place of the fresh one.
+     */
+    bool leafMatches(AView& live, ILuaExposedView& liveLua, AView& fresh) {
+        if (live.getVisibility() != fresh.getVisibility() || live.isEnabled() != fresh.isEnabled()) {
+            return false;
+        }
+        if (auto liveLabel = dynamic_cast<AAbstractLabel*>(&live)) {
+            return AString(liveLabel->text()) == AString(static_cast<AAbstractLabel&>(fresh).text());
+        }
+        // typed text is the state worth keeping
+        return dynamic_cast<MyTextField*>(&live) || dynamic_cast<MyTextArea*>(&live) ||
+               liveLua.exposedAs<AView>() != nullptr;
+    }
+
+    void applyStyle(AView& live, ILuaExposedView& liveLua, ILuaExposedView& freshLua) {
+        if (liveLua.appliedStyle() == freshLua.appliedStyle()) {
+            return;
+        }
+        auto compiled = std::static_pointer_cast<const StyleCache::Compiled>(freshLua.appliedStyle());
+        if (!compiled) {
+            live.setCustomStyle({});
+            live.setExtraStylesheet(nullptr);
+        } else if (compiled->stylesheet) {
+            // the live view may carry the other kind of style from before the edit
+            live.setCustomStyle({});
+            live.setExtraStylesheet(compiled->stylesheet);
+        } else {
+            live.setExtraStylesheet(nullptr);
+            live.setCustomStyle(compiled->customStyle);
+        }
+        liveLua.setAppliedStyle(compiled);
+    }
+}
+
+HotReload::~HotReload() {
+    AUI_NULLSAFE(mTimer)->stop();
+}
+
+void HotReload::setPolling(bool enabled, std::chrono::milliseconds pollInterval) {
+    if (mTimer) {
+        mTimer->stop();
+        mTimer = nullptr;
+    }
+    auto& styleCache = mUiEngine.styleCache();
+    if (!enabled) {
+        if (mPreviousStructuralHashing) {
+            styleCache.setStructuralHashing(*mPreviousStructuralHashing);
+            mPreviousStructuralHashing.reset();
+        }
+        return;
+    }
+    // unchanged style tables of a reloaded form have to resolve to the styles the live views use
+    if (!mPreviousStructuralHashing) {
+        mPreviousStructuralHashing = styleCache.structuralHashing();
+    }
+    styleCache.setStructuralHashing(true);
+    mTimer = _new<ATimer>(pollInterval);
+    AObject::connect(mTimer->fired, mTimer, [this] {
+        poll();
+    });
+    mTimer->start();
+}
+
+void HotReload::formLoaded(const std::filesystem::path& file, const _<AView>& root) {
+    std::error_code ec;
+    auto& form = mForms[file.string()];
+    form.modified = std::filesystem::last_write_time(file, ec);
+    form.root = root;
+}
+
+void HotReload::poll() {
+    std::vector<std::filesystem::path> changed;
+    for (auto& [file, form] : mForms) {
+        std::error_code ec;
+        auto modified = std::filesystem::last_write_time(file, ec);
+        if (!ec && modified != form.modified) {
+            form.modified = modified;
+            changed.emplace_back(file);
+        }
+    }
+    // reloading may load other forms, i.e., modify mForms
+    for (const auto& file : changed) {
+        reload(file);
+    }
+}
+
+bool HotReload::reload(const std::filesystem::path& file) {
+    if (!mForms.contains(file.string())) {
+        return false;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    lua_State* L = mUiEngine.luaState();
+    clg::stack_integrity_check check(L);
+    mStats = {};
+    mReloading = true;
+    ARaiiHelper done = [&] {
+        mReloading = false;
+        mSurfaceFresh = nullptr;
+        mSurfaceResult = nullptr;
+    };
+    try {
+        LuaChunkLoader::load(L, file, mUiEngine.mBytecodeCacheDir.empty()
+                                          ? std::filesystem::path()
+                                          : std::filesystem::path(mUiEngine.mBytecodeCacheDir.toStdString()));
+    } catch (const AException& e) {
+        ALogger::err(LOG_TAG) << "Unable to reload form " << file.string() << ": " << e;
+        return false;
+    } catch (const std::exception& e) {
+        ALogger::err(LOG_TAG) << "Unable to reload form " << file.string() << ": " << e.what();
+        return false;
+    }
+    auto fresh = mUiEngine.runForm(L, file.string());
+
+    auto& form = mForms[file.string()];
+    if (fresh) {
+        if (fresh.get() == mSurfaceFresh) {
+            form.root = mSurfaceResult;
+        } else if (auto live = form.root.lock(); live && live->getParent()) {
+            form.root = reconcile(live, fresh);
+        } else {
+            form.root = fresh;
+        }
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    ALogger::info(LOG_TAG) << "Reloaded " << file.string() << " in " << elapsed.count() << " ms: " << mStats.reused
+                           << " views reused, " << mStats.created << " created";
+    return true;
+}
+
+void HotReload::reconcileSurface(const _<AView>& fresh) {
+    mSurfaceFresh = fresh.get();
+    if (mUiEngine.mSurface.getViews().empty() || !fresh) {
+        ALayoutInflater::inflate(mUiEngine.mSurface, fresh);
+        mSurfaceResult = fresh;
+        return;
+    }
+    auto live = mUiEngine.mSurface.getViews().first();
+    mSurfaceResult = reconcile(live, fresh);
+}
+
+_<AView> HotReload::reconcile(const _<AView>& live, const _<AView>& fresh) {
+    mUiEngine.invalidationBatch().begin();
+    ARaiiHelper end = [&] {
+        mUiEngine.invalidationBatch().end();
+    };
+    auto result = reconcileView(live, fresh);
+    if (result != live) {
+        replace(live, result);
+    }
+    return result;
+}
+
+_<AView> HotReload::reconcileView(const _<AView>& live, const _<AView>& fresh) {
+    auto liveLua = ILuaExposedView::fromView(live.get());
+    auto freshLua = ILuaExposedView::fromView(fresh.get());
+    if (liveLua == nullptr || freshLua == nullptr || !sameKind(*live, *fresh) || liveLua->hasLuaState() ||
+        freshLua->hasLuaState()) {
+        ++mStats.created;
+        return fresh;
+    }
+
+    if (liveLua->container() != nullptr) {
+        if (!isPlainContainer(*liveLua)) {
+            ++mStats.created;
+            return fresh;
+        }
+        reconcileChildren(_cast<AViewContainer>(live), _cast<AViewContainer>(fresh));
+    } else if (!leafMatches(*live, *liveLua, *fresh)) {
+        ++mStats.created;
+        return fresh;
+    }
+    applyStyle(*live, *liveLua, *freshLua);
+    ++mStats.reused;
+    return live;
+}
+
+void HotReload::reconcileChildren(const _<AViewContainer>& live, const _<AViewContainer>& fresh) {
+    auto liveChildren = live->getViews();
+    auto freshChildren = fresh->getViews();
+    // the fresh container is dropped; its children must not point to it
+    fresh->removeAllViews();
+    UIEngine::removeAllChildren(fresh);
+
+    std::unordered_map<std::string, std::deque<std::size_t>> liveByKind;
+    for (std::size_t i = 0; i < liveChildren.size(); ++i) {
+        liveByKind[kindKey(*liveChildren[i])].push_back(i);
+    }
+
+    // children are paired in order: a fresh child takes the first unpaired live child of its kind after the
+    // previous pair
+    AVector<_<AView>> result;
+    result.reserve(freshChildren.size());
+    std::size_t cursor = 0;
+    for (const auto& child : freshChildren) {
+        auto it = liveByKind.find(kindKey(*child));
+        if (it != liveByKind.end()) {
+            auto& candidates = it->second;
+            while (!candidates.empty() && candidates.front() < cursor) {
+                candidates.pop_front();
+            }
+            if (!candidates.empty()) {
+                cursor = candidates.front() + 1;
+                candidates.pop_front();
+                result << reconcileView(liveChildren[cursor - 1], child);
+                continue;
+            }
+        }
+        ++mStats.created;
+        result << child;
+    }
+
+    if (result == liveChildren) {
+        return;
+    }
+    live->removeAllViews();
+    UIEngine::removeAllChildren(live);
+    live->addViews(result);
+    UIEngine::addChildren(live, result);
+    mUiEngine.invalidationBatch().minContentSizeChanged(live);
+}
+
+void HotReload::replace(const _<AView>& live, const _<AView>& result) {
+    auto parent = live->getParent();
+    if (parent == nullptr) {
+        return;
+    }
+    if (parent == &mUiEngine.mSurface) {
+        ALayoutInflater::inflate(mUiEngine.mSurface, result);
+        return;
+    }
+    auto container = _cast<AViewContainer>(aui::ptr::shared_from_this(parent));
+    auto index = container->getViews().indexOf(live);
+    container->removeView(live);
+    UIEngine::removeChild(container, live);
+    container->addView(index, result);
+    UIEngine::addChild(container, result);
+    mUiEngine.invalidationBatch().minContentSizeChanged(container);
+}
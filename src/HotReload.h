@@ -0,0 +1,115 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#pragma once
+
+#include <AUI/View/AViewContainer.h>
+#include <AUI/Util/ATimer.h>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+class UIEngine;
+
+/**
+ * @brief Hot reload of forms loaded with UIEngine::loadForm.
+ * @details
+ * A changed form file is run again and the view tree it produces is reconciled with the live one, so views that did
+ * not change stay in place with their state (typed text, geometry, focus, children of reused containers):
+ * - views are matched by class, layout and stylesheet names; children of a container are matched in order;
+ * - a matched plain container is kept, its children are reconciled recursively;
+ * - a matched label, text field or plain view is kept; a label whose text differs is replaced;
+ * - a kept view gets the style of the new one if it differs (styles are compared by identity, with structural style
+ *   hashing enabled while hot reload is on, so an unchanged style table resolves to the style the live view uses);
+ * - views with Lua state (signal handlers, fields, overrides) are always replaced, since their handlers refer to the
+ *   previous run of the form.
+ */
+class HotReload {
+public:
+    explicit HotReload(UIEngine& uiEngine): mUiEngine(uiEngine) {}
+    ~HotReload();
+
+    HotReload(const HotReload&) = delete;
+
+    struct Stats {
+        std::size_t reused = 0;
+        std::size_t created = 0;
+    };
+
+    void setPolling(bool enabled, std::chrono::milliseconds pollInterval);
+
+    [[nodiscard]]
+    bool enabled() const noexcept {
+        return mTimer != nullptr;
+    }
+
+    /**
+     * @brief Starts watching the form file; root is the view returned by it.
+     */
+    void formLoaded(const std::filesystem::path& file, const _<AView>& root);
+
+    /**
+     * @brief Runs the form again and reconciles its views with the live ones.
+     * @return false if the form is not watched or failed to run.
+     */
+    bool reload(const std::filesystem::path& file);
+
+    [[nodiscard]]
+    bool reloading() const noexcept {
+        return mReloading;
+    }
+
+    /**
+     * @brief Reconciles the view passed to UI.setSurface during a reload with the current surface contents.
+     */
+    void reconcileSurface(const _<AView>& fresh);
+
+    /**
+     * @brief Reconciles fresh with live and puts the result in place of live.
+     * @return the view that is in the tree now: live, if it was kept, or fresh.
+     */
+    _<AView> reconcile(const _<AView>& live, const _<AView>& fresh);
+
+    [[nodiscard]]
+    const Stats& lastStats() const noexcept {
+        return mStats;
+    }
+
+private:
+    struct Form {
+        std::filesystem::file_time_type modified;
+        std::weak_ptr<AView> root;
+    };
+
+    UIEngine& mUiEngine;
+    std::unordered_map<std::string, Form> mForms;
+    _<ATimer> mTimer;
+    bool mReloading = false;
+
+    /**
+     * @brief Structural hashing setting of the style cache before polling turned it on; restored when polling stops.
+     */
+    std::optional<bool> mPreviousStructuralHashing;
+    Stats mStats;
+
+    /**
+     * @brief Result of UI.setSurface during the current reload.
+     */
+    AView* mSurfaceFresh = nullptr;
+    _<AView> mSurfaceResult;
+
+    void poll();
+    _<AView> reconcileView(const _<AView>& live, const _<AView>& fresh);
+    void reconcileChildren(const _<AViewContainer>& live, const _<AViewContainer>& fresh);
+    void replace(const _<AView>& live, const _<AView>& result);
+};
@@ -13,3 +13,308 @@
 //
 
 #include <uiengine/ILuaExposedView.h>
+#include <uiengine/UIEngine.h>
+#include <uiengine/LuaCanvas.h>
+#include <AUI/Logging/ALogger.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+
+namespace {
+    constexpr const char* CHILD_ANCHORS = "cpp_children";
+
+    /**
+     * @brief Open addressing table of LuaExposedView classes, keyed by the address of their type_info.
+     * @details
+     * Written once per class under a mutex; read without locking: a slot's offset is written before its type is
+     * published, so a reader that sees the type sees the offset as well.
+     */
+    struct ExposedClass {
+        std::atomic<const std::type_info*> type = nullptr;
+        std::ptrdiff_t offset = 0;
+    };
+
+    constexpr std::size_t EXPOSED_CLASS_CAPACITY = 256;
+
+    std::array<ExposedClass, EXPOSED_CLASS_CAPACITY> gExposedClasses;
+    std::mutex gExposedClassesSync;
+
+    /**
+     * @brief Set once a class did not fit into the table; fromView falls back to dynamic_cast from then on.
+     */
+    std::atomic<bool> gExposedClassesOverflow = false;
+
+    std::size_t exposedClassSlot(const std::type_info* type) noexcept {
+        return (reinterpret_cast<std::uintptr_t>(type) >> 4) % EXPOSED_CLASS_CAPACITY;
+    }
+}
+
+ILuaExposedView::~ILuaExposedView() = default;
+
+void ILuaExposedView::registerClass(const std::type_info& type, const AView* view) {
+    const auto offset = reinterpret_cast<const char*>(this) - reinterpret_cast<const char*>(view);
+    std::unique_lock lock(gExposedClassesSync);
+    auto slot = exposedClassSlot(&type);
+    for (std::size_t probe = 0; probe < EXPOSED_CLASS_CAPACITY; ++probe, slot = (slot + 1) % EXPOSED_CLASS_CAPACITY) {
+        auto& entry = gExposedClasses[slot];
+        auto existing = entry.type.load(std::memory_order_relaxed);
+        if (existing == &type) {
+            return;
+        }
+        if (existing == nullptr) {
+            entry.offset = offset;
+            entry.type.store(&type, std::memory_order_release);
+            return;
+        }
+    }
+    // the class still works, through the dynamic_cast fallback of fromView, but every lookup of any view that is not
+    // in the table pays for it from now on
+    gExposedClassesOverflow.store(true, std::memory_order_release);
+    ALogger::err("ILuaExposedView") << "More than " << EXPOSED_CLASS_CAPACITY << " LuaExposedView classes; "
+                                    << type.name() << " is looked up by dynamic_cast. Increase EXPOSED_CLASS_CAPACITY";
+    assert(("LuaExposedView class table is full", false));
+}
+
+void ILuaExposedView::luaFrameRendered() {
+    mUiEngine.gcPacer().frameRendered();
+}
+
+void ILuaExposedView::setDraw(const clg::ref& draw) {
+    auto holder = luaDataHolder();
+    if (draw.isNull()) {
+        if (!holder.isNull()) {
+            holder["cpp_draw"] = clg::ref(nullptr);
+        }
+        mCanvas = nullptr;
+        view()->redraw();
+        return;
+    }
+    holder["cpp_draw"] = draw;
+    if (!mCanvas) {
+        mCanvas = std::make_shared<LuaCanvas>();
+        // the canvas may outlive the view if Lua keeps it
+        mCanvas->setOnImageLoaded([this, view = view()->weak_from_this()] {
+            if (!view.expired()) {
+                invalidateDraw();
+            }
+        });
+    }
+    invalidateDraw();
+}
+
+void ILuaExposedView::invalidateDraw() {
+    if (!mCanvas) {
+        return;
+    }
+    mCanvasDirty = true;
+    view()->redraw();
+}
+
+void ILuaExposedView::luaRenderCanvas(IRenderer& render) {
+    if (!mCanvas) {
+        return;
+    }
+    auto size = view()->getSize();
+    if (mCanvasDirty || size != mCanvasSize) {
+        mCanvasDirty = false;
+        mCanvasSize = size;
+        mCanvas->clear();
+        try {
+            luaDataHolder()["cpp_draw"].invokeNullsafe(aui::ptr::shared_from_this(view()), mCanvas);
+        } catch (const std::exception& e) {
+            ALogger::err("LuaCanvas") << "Draw function failed: " << e.what();
+        }
+    }
+    mCanvas->replay(render);
+}
+
+void ILuaExposedView::setMinSizeMemoization(bool enabled) {
+    if (!enabled) {
+        mMinSizeMemo = nullptr;
+    } else if (!mMinSizeMemo) {
+        mMinSizeMemo = std::make_unique<std::array<std::optional<int>, 4>>();
+    }
+}
+
+std::optional<int> ILuaExposedView::memoizedMinSize(MinSizeQuery query) {
+    if (!mMinSizeMemo) {
+        return std::nullopt;
+    }
+    auto& stats = mUiEngine.minSizeMemoStats();
+    auto value = (*mMinSizeMemo)[static_cast<std::size_t>(query)];
+    if (value) {
+        ++stats.hits;
+    } else {
+        ++stats.misses;
+    }
+    return value;
+}
+
+bool ILuaExposedView::hasLuaState() {
+    if (!mSignalHandlers.empty()) {
+        return true;
+    }
+    auto holder = luaDataHolder();
+    if (holder.isNull()) {
+        return false;
+    }
+    lua_State* L = mUiEngine.luaState();
+    clg::stack_integrity_check check(L);
+    holder.push_value_to_stack(L);
+    lua_pushnil(L);
+    while (lua_next(L, -2)) {
+        lua_pop(L, 1);
+        if (lua_type(L, -1) != LUA_TSTRING || std::string_view(lua_tostring(L, -1)) != CHILD_ANCHORS) {
+            lua_pop(L, 2);
+            return true;
+        }
+    }
+    lua_pop(L, 1);
+    return false;
+}
+
+bool ILuaExposedView::pushChildAnchors(lua_State* L, bool create) {
+    auto holder = luaDataHolder();
+    if (holder.isNull()) {
+        return false;
+    }
+    holder.push_value_to_stack(L);
+    lua_pushstring(L, CHILD_ANCHORS);
+    lua_rawget(L, -2);
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 2);
+        if (!create) {
+            return false;
+        }
+        // the previous array (if any) is gone together with whatever it anchored
+        mSlotViews.clear();
+        mFreeChildSlots.clear();
+        holder.push_value_to_stack(L);
+        lua_createtable(L, 0, 0);
+        lua_pushstring(L, CHILD_ANCHORS);
+        lua_pushvalue(L, -2);
+        lua_rawset(L, -4);
+    }
+    lua_remove(L, -2);
+    return true;
+}
+
+int ILuaExposedView::takeChildSlot(const AView* view) {
+    int slot;
+    if (mFreeChildSlots.empty()) {
+        mSlotViews.push_back(view);
+        slot = int(mSlotViews.size());
+    } else {
+        slot = mFreeChildSlots.back();
+        mFreeChildSlots.pop_back();
+        mSlotViews[slot - 1] = view;
+    }
+    if (auto child = fromView(view)) {
+        child->mAnchorOwner = this;
+        child->mAnchorSlot = slot;
+    }
+    return slot;
+}
+
+int ILuaExposedView::findChildSlot(const AView* view, bool scan) const noexcept {
+    auto child = fromView(view);
+    if (child && child->mAnchorOwner == this) {
+        auto slot = child->mAnchorSlot;
+        return std::size_t(slot - 1) < mSlotViews.size() && mSlotViews[slot - 1] == view ? slot : 0;
+    }
+    if (child && !scan) {
+        // a LuaExposedView without a record of this container was not anchored by it (or was anchored by another
+        // container since, which makes a duplicate slot at worst)
+        return 0;
+    }
+    auto it = std::find(mSlotViews.begin(), mSlotViews.end(), view);
+    return it == mSlotViews.end() ? 0 : int(it - mSlotViews.begin()) + 1;
+}
+
+void ILuaExposedView::anchorChildren(std::span<const _<AView>> views) {
+    if (views.empty()) {
+        return;
+    }
+    lua_State* L = mUiEngine.luaState();
+    clg::stack_integrity_check check(L);
+    if (!pushChildAnchors(L, true)) {
+        return;
+    }
+    for (const auto& view : views) {
+        if (findChildSlot(view.get(), false) != 0) {
+            continue;
+        }
+        clg::push_to_lua(L, view);
+        lua_rawseti(L, -2, takeChildSlot(view.get()));
+    }
+    lua_pop(L, 1);
+}
+
+void ILuaExposedView::releaseChildren(std::span<const _<AView>> views) {
+    if (views.empty() || mSlotViews.size() == mFreeChildSlots.size()) {
+        return;
+    }
+    lua_State* L = mUiEngine.luaState();
+    clg::stack_integrity_check check(L);
+    if (!pushChildAnchors(L, false)) {
+        return;
+    }
+    for (const auto& view : views) {
+        auto slot = findChildSlot(view.get(), true);
+        if (slot == 0) {
+            continue;
+        }
+        lua_pushnil(L);
+        lua_rawseti(L, -2, slot);
+        mSlotViews[slot - 1] = nullptr;
+        mFreeChildSlots.push_back(slot);
+        if (auto child = fromView(view.get()); child && child->mAnchorOwner == this) {
+            child->mAnchorOwner = nullptr;
+            child->mAnchorSlot = 0;
+        }
+    }
+    lua_pop(L, 1);
+}
+
+void ILuaExposedView::releaseAllChildren() {
+    mSlotViews.clear();
+    mFreeChildSlots.clear();
+    auto holder = luaDataHolder();
+    if (holder.isNull()) {
+        return;
+    }
+    lua_State* L = mUiEngine.luaState();
+    clg::stack_integrity_check check(L);
+    holder.push_value_to_stack(L);
+    lua_pushstring(L, CHILD_ANCHORS);
+    lua_pushnil(L);
+    lua_rawset(L, -3);
+    lua_pop(L, 1);
+}
+
+ILuaExposedView* ILuaExposedView::fromView(const AView* view) noexcept {
+    if (!view) {
+        return nullptr;
+    }
+    const auto* type = &typeid(*view);
+    auto slot = exposedClassSlot(type);
+    for (std::size_t probe = 0; probe < EXPOSED_CLASS_CAPACITY; ++probe, slot = (slot + 1) % EXPOSED_CLASS_CAPACITY) {
+        auto& entry = gExposedClasses[slot];
+        auto existing = entry.type.load(std::memory_order_acquire);
+        if (existing == type) {
+            return reinterpret_cast<ILuaExposedView*>(const_cast<char*>(reinterpret_cast<const char*>(view)) + entry.offset);
+        }
+        if (existing == nullptr) {
+            if (!gExposedClassesOverflow.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            break;
+        }
+    }
+    // the table is full: classes that did not fit are found the slow way
+    return dynamic_cast<ILuaExposedView*>(const_cast<AView*>(view));
+}
@@ -0,0 +1,58 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include "InvalidationBatch.h"
+
+void InvalidationBatch::end() {
+    if (mDepth == 0 || --mDepth > 0) {
+        return;
+    }
+    // applying may run Lua (overrides, signal handlers) that starts another batch; it is applied on its own
+    auto styles = mStyles.take();
+    auto geometry = mGeometry.take();
+    auto minContentSizes = mMinContentSizes.take();
+    for (const auto& view : styles) {
+        view->invalidateAssHelper();
+    }
+    for (const auto& container : geometry) {
+        if (container->getParent()) {
+            container->applyGeometryToChildrenIfNecessary();
+        }
+    }
+    for (const auto& container : minContentSizes) {
+        container->markMinContentSizeInvalid();
+    }
+}
+
+void InvalidationBatch::minContentSizeChanged(const _<AViewContainer>& container) {
+    if (!active()) {
+        container->markMinContentSizeInvalid();
+        return;
+    }
+    mMinContentSizes.add(container);
+}
+
+void InvalidationBatch::styleChanged(const _<AView>& view) {
+    if (!active()) {
+        view->invalidateAssHelper();
+        return;
+    }
+    mStyles.add(view);
+}
+
+void InvalidationBatch::geometryChanged(const _<AViewContainer>& container) {
+    if (!active()) {
+        if (container->getParent()) {
+            container->applyGeometryToChildrenIfNecessary();
+        }
+        return;
+    }
+    mGeometry.add(container);
+}
@@ -0,0 +1,70 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#pragma once
+
+#include <AUI/View/AViewContainer.h>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Invalidations of the view tree made by the container bindings (addView, removeView, ...).
+ * @details
+ * Outside of a batch, invalidations are applied immediately. Inside of UI.batch, each view is invalidated once, when
+ * the outermost batch ends: styles first, then geometry, then minimum sizes, as the bindings do for a single change.
+ */
+class InvalidationBatch {
+public:
+    void begin() noexcept {
+        ++mDepth;
+    }
+
+    /**
+     * @brief Ends a batch; applies the collected invalidations if it was the outermost one.
+     */
+    void end();
+
+    [[nodiscard]]
+    bool active() const noexcept {
+        return mDepth > 0;
+    }
+
+    void minContentSizeChanged(const _<AViewContainer>& container);
+    void styleChanged(const _<AView>& view);
+
+    /**
+     * @brief Geometry of the container's children has to be reapplied (if it is attached).
+     */
+    void geometryChanged(const _<AViewContainer>& container);
+
+private:
+    template<typename T>
+    struct Set {
+        std::vector<_<T>> items;
+        std::unordered_set<T*> known;
+
+        void add(const _<T>& item) {
+            if (known.insert(item.get()).second) {
+                items.push_back(item);
+            }
+        }
+
+        std::vector<_<T>> take() {
+            known.clear();
+            return std::exchange(items, {});
+        }
+    };
+
+    unsigned mDepth = 0;
+    Set<AView> mStyles;
+    Set<AViewContainer> mGeometry;
+    Set<AViewContainer> mMinContentSizes;
+};
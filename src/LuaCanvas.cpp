@@ -0,0 +1,141 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include <uiengine/LuaCanvas.h>
+#include <uiengine/Converters.h>
+#include <AUI/Render/IRenderer.h>
+#include <AUI/Render/ABrush.h>
+#include <AUI/Render/ABorderStyle.h>
+#include <AUI/Font/AFontStyle.h>
+#include <AUI/Url/AUrl.h>
+#include <AUI/Common/AException.h>
+#include <AUI/Logging/ALogger.h>
+#include <AUI/Thread/AThread.h>
+#include <AUI/Thread/AThreadPool.h>
+#include <optional>
+
+namespace {
+    template<typename... Ts>
+    struct overloaded: Ts... {
+        using Ts::operator()...;
+    };
+}
+
+void LuaCanvas::registerClass(lua_State* L) {
+    clg::state_interface(L).register_class<LuaCanvas>()
+        .method("rect", [](const _<LuaCanvas>& self, float x, float y, float w, float h, AColor color) {
+            self->add(Rect{ .position = {x, y}, .size = {w, h}, .color = color });
+        })
+        .method("roundedRect", [](const _<LuaCanvas>& self, float x, float y, float w, float h, float radius, AColor color) {
+            self->add(Rect{ .position = {x, y}, .size = {w, h}, .color = color, .radius = radius });
+        })
+        .method("rectBorder", [](const _<LuaCanvas>& self, float x, float y, float w, float h, AColor color,
+                                 std::optional<float> width, std::optional<float> radius) {
+            self->add(Rect{ .position = {x, y}, .size = {w, h}, .color = color, .radius = radius.value_or(0.f),
+                            .borderWidth = width.value_or(1.f) });
+        })
+        .method("line", [](const _<LuaCanvas>& self, float x1, float y1, float x2, float y2, AColor color,
+                           std::optional<float> width) {
+            self->add(Lines{ .points = { {x1, y1}, {x2, y2} }, .color = color, .width = width.value_or(1.f) });
+        })
+        .method("path", [](const _<LuaCanvas>& self, const AVector<float>& coords, AColor color,
+                           std::optional<float> width, std::optional<bool> closed) {
+            if (coords.size() % 2 != 0) {
+                throw AException("path: expected a flat array of x, y pairs");
+            }
+            Lines lines{ .color = color, .width = width.value_or(1.f) };
+            lines.points.reserve(coords.size() / 2 + 1);
+            for (std::size_t i = 0; i < coords.size(); i += 2) {
+                lines.points.emplace_back(coords[i], coords[i + 1]);
+            }
+            if (closed.value_or(false) && lines.points.size() > 2) {
+                lines.points.push_back(lines.points.front());
+            }
+            self->add(std::move(lines));
+        })
+        .method("text", [](const _<LuaCanvas>& self, float x, float y, const AString& text, AColor color,
+                           std::optional<int> size) {
+            self->add(Text{ .position = {x, y}, .text = text, .color = color, .size = unsigned(size.value_or(12)) });
+        })
+        .method("image", [](const _<LuaCanvas>& self, const std::string& url, float x, float y, float w, float h) {
+            if (auto drawable = self->image(url)) {
+                self->add(Image{ .drawable = std::move(drawable), .position = {x, y}, .size = {w, h} });
+            }
+        })
+        .method("commandCount", [](const _<LuaCanvas>& self) {
+            return self->size();
+        });
+}
+
+_<IDrawable> LuaCanvas::image(const std::string& url) {
+    if (auto it = mImages.find(url); it != mImages.end()) {
+        return it->second;
+    }
+    if (!mLoadingImages.insert(url).second) {
+        return nullptr;
+    }
+    std::weak_ptr<LuaCanvas> self = weak_from_this();
+    AThreadPool::global().run([self, url] {
+        _<IDrawable> drawable;
+        try {
+            drawable = IDrawable::fromUrl(AUrl(AString(url)));
+        } catch (const AException& e) {
+            ALogger::err("LuaCanvas") << "Unable to load image " << url << ": " << e;
+        } catch (const std::exception& e) {
+            ALogger::err("LuaCanvas") << "Unable to load image " << url << ": " << e.what();
+        }
+        AThread::main()->enqueue([self, url, drawable = std::move(drawable)] {
+            auto canvas = self.lock();
+            if (!canvas) {
+                return;
+            }
+            canvas->mLoadingImages.erase(url);
+            // a failed image is remembered as well, so it is not requested on every recording
+            canvas->mImages[url] = drawable;
+            if (drawable && canvas->mOnImageLoaded) {
+                canvas->mOnImageLoaded();
+            }
+        });
+    });
+    return nullptr;
+}
+
+void LuaCanvas::replay(IRenderer& render) const {
+    for (const auto& command : mCommands) {
+        std::visit(overloaded {
+            [&](const Rect& r) {
+                ASolidBrush brush{ r.color };
+                if (r.borderWidth > 0.f) {
+                    if (r.radius > 0.f) {
+                        render.roundedRectangleBorder(brush, r.position, r.size, r.radius, int(r.borderWidth));
+                    } else {
+                        render.rectangleBorder(brush, r.position, r.size, r.borderWidth);
+                    }
+                } else if (r.radius > 0.f) {
+                    render.roundedRectangle(brush, r.position, r.size, r.radius);
+                } else {
+                    render.rectangle(brush, r.position, r.size);
+                }
+            },
+            [&](const Lines& l) {
+                render.lines(ASolidBrush{ l.color }, l.points, ABorderStyle::Solid{}, AMetric(l.width, AMetric::T_PX));
+            },
+            [&](const Text& t) {
+                AFontStyle fs;
+                fs.size = t.size;
+                fs.color = t.color;
+                render.string(t.position, t.text, fs);
+            },
+            [&](const Image& i) {
+                i.drawable->draw(render, IDrawable::Params{ .offset = i.position, .size = i.size });
+            },
+        }, command);
+    }
+}
@@ -0,0 +1,210 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include "LuaChunkLoader.h"
+#include "MappedFile.h"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <AUI/Common/AException.h>
+#include <AUI/Logging/ALogger.h>
+#include "lauxlib.h"
+
+static constexpr auto LOG_TAG = "LuaChunkLoader";
+
+namespace {
+    /**
+     * @brief Longest prefix of the form name kept in the cache entry name, in bytes.
+     */
+    constexpr std::size_t CACHE_NAME_PREFIX = 48;
+
+    std::uint64_t fnv1a(std::string_view bytes, std::uint64_t hash = 0xcbf29ce484222325ull) noexcept {
+        for (char c : bytes) {
+            hash ^= std::uint8_t(c);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    std::string toHex(std::uint64_t value) {
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(value));
+        return hex;
+    }
+}
+
+std::uint64_t LuaChunkLoader::sourceHash(std::string_view source) noexcept {
+    const int salt[] = { LUA_VERSION_NUM, int(sizeof(lua_Number)), int(sizeof(lua_Integer)), int(sizeof(void*)) };
+    return fnv1a(source, fnv1a({ reinterpret_cast<const char*>(salt), sizeof(salt) }));
+}
+
+std::string LuaChunkLoader::dump(lua_State* L) {
+    std::string result;
+    auto writer = [](lua_State*, const void* p, size_t size, void* ud) -> int {
+        static_cast<std::string*>(ud)->append(static_cast<const char*>(p), size);
+        return 0;
+    };
+#if LUA_VERSION_NUM >= 503
+    lua_dump(L, writer, &result, 0);
+#else
+    lua_dump(L, writer, &result);
+#endif
+    return result;
+}
+
+std::filesystem::path LuaChunkLoader::cachePath(const std::filesystem::path& file, const std::filesystem::path& cacheDir, std::uint64_t hash) {
+    // the path is identified by its hash, so deep form trees stay within NAME_MAX; the (possibly truncated) file name
+    // is kept for readability only. The name is cut on a UTF-8 character boundary
+    auto name = file.stem().string();
+    if (name.size() > CACHE_NAME_PREFIX) {
+        auto length = CACHE_NAME_PREFIX;
+        while (length > 0 && (std::uint8_t(name[length]) & 0xc0) == 0x80) {
+            --length;
+        }
+        name.resize(length);
+    }
+    return cacheDir / (name + "." + toHex(fnv1a(file.generic_string())) + "." + toHex(hash) + ".luac");
+}
+
+std::string LuaChunkLoader::readFile(const std::filesystem::path& file) {
+    std::ifstream fis(file, std::ios::binary);
+    if (!fis) {
+        throw AException("unable to open {}"_format(file.string()));
+    }
+    return { std::istreambuf_iterator<char>(fis), std::istreambuf_iterator<char>() };
+}
+
+void LuaChunkLoader::writeCache(const std::filesystem::path& file, const std::filesystem::path& cacheDir, std::uint64_t hash, std::string_view bytecode) {
+    std::error_code ec;
+    std::filesystem::create_directories(cacheDir, ec);
+
+    // write to a temporary file first so a concurrently starting process never maps a partially written entry; the
+    // name is unique so concurrent writers (other processes, loadFormAsync workers) never share it
+    auto destination = cachePath(file, cacheDir, hash);
+    auto tmp = destination;
+    {
+        static std::atomic<std::uint64_t> counter{0};
+        std::random_device random;
+        char suffix[48];
+        std::snprintf(suffix, sizeof(suffix), ".%08x%08x.%llu.tmp", random(), random(),
+                      static_cast<unsigned long long>(counter.fetch_add(1, std::memory_order_relaxed)));
+        tmp += suffix;
+    }
+    {
+        std::ofstream fos(tmp, std::ios::binary | std::ios::trunc);
+        fos.write(bytecode.data(), std::streamsize(bytecode.size()));
+        if (!fos) {
+            ALogger::warn(LOG_TAG) << "Unable to write bytecode cache " << tmp.string();
+            return;
+        }
+    }
+    std::filesystem::rename(tmp, destination, ec);
+    if (ec) {
+        ALogger::warn(LOG_TAG) << "Unable to write bytecode cache " << destination.string() << ": " << ec.message();
+        std::filesystem::remove(tmp, ec);
+        return;
+    }
+
+    // drop entries of other revisions of the same form; temporary files of other writers do not end with .luac
+    auto entryName = destination.filename().string();
+    auto prefix = std::string_view(entryName).substr(0, entryName.size() - std::string_view("0000000000000000.luac").size());
+    // the cache is best effort: iteration uses the error_code overloads, so a concurrent writer or a permission
+    // problem stops the cleanup instead of failing the load
+    std::filesystem::directory_iterator it(cacheDir, ec), end;
+    for (; !ec && it != end; it.increment(ec)) {
+        auto name = it->path().filename().string();
+        if (name != entryName && name.size() == entryName.size() && name.starts_with(prefix) && name.ends_with(".luac")) {
+            std::error_code removeError;
+            std::filesystem::remove(it->path(), removeError);
+        }
+    }
+}
+
+namespace {
+    using PrivateState = std::unique_ptr<lua_State, decltype(&lua_close)>;
+
+    PrivateState newPrivateState() {
+        PrivateState L(luaL_newstate(), lua_close);
+        if (!L) {
+            throw AException("unable to create a Lua state");
+        }
+        return L;
+    }
+}
+
+std::string LuaChunkLoader::compile(std::string_view source, const std::string& chunkName) {
+    auto L = newPrivateState();
+    if (luaL_loadbufferx(L.get(), source.data(), source.size(), chunkName.c_str(), "t") != LUA_OK) {
+        throw AException(lua_tostring(L.get(), -1));
+    }
+    return dump(L.get());
+}
+
+std::string LuaChunkLoader::compileFile(const std::filesystem::path& file, const std::filesystem::path& cacheDir) {
+    auto source = readFile(file);
+    auto chunkName = "@" + file.generic_string();
+    if (cacheDir.empty()) {
+        return compile(source, chunkName);
+    }
+
+    auto hash = sourceHash(source);
+    if (MappedFile cached(cachePath(file, cacheDir, hash)); cached) {
+        // validate the entry here rather than on the UI thread
+        auto L = newPrivateState();
+        if (luaL_loadbufferx(L.get(), cached.data(), cached.size(), chunkName.c_str(), "b") == LUA_OK) {
+            return std::string(cached.view());
+        }
+        ALogger::warn(LOG_TAG) << "Corrupted bytecode cache for " << file.string() << ": " << lua_tostring(L.get(), -1);
+    }
+
+    auto bytecode = compile(source, chunkName);
+    writeCache(file, cacheDir, hash, bytecode);
+    return bytecode;
+}
+
+void LuaChunkLoader::loadBytecode(lua_State* L, std::string_view bytecode, const std::string& chunkName) {
+    if (luaL_loadbufferx(L, bytecode.data(), bytecode.size(), chunkName.c_str(), "b") != LUA_OK) {
+        std::string message = lua_tostring(L, -1);
+        lua_pop(L, 1);
+        throw AException(message);
+    }
+}
+
+void LuaChunkLoader::load(lua_State* L, const std::filesystem::path& file, const std::filesystem::path& cacheDir) {
+    auto source = readFile(file);
+    auto chunkName = "@" + file.generic_string();
+
+    if (cacheDir.empty()) {
+        if (luaL_loadbufferx(L, source.data(), source.size(), chunkName.c_str(), "t") != LUA_OK) {
+            std::string message = lua_tostring(L, -1);
+            lua_pop(L, 1);
+            throw AException(message);
+        }
+        return;
+    }
+
+    auto hash = sourceHash(source);
+    if (MappedFile cached(cachePath(file, cacheDir, hash)); cached) {
+        if (luaL_loadbufferx(L, cached.data(), cached.size(), chunkName.c_str(), "b") == LUA_OK) {
+            return;
+        }
+        ALogger::warn(LOG_TAG) << "Corrupted bytecode cache for " << file.string() << ": " << lua_tostring(L, -1);
+        lua_pop(L, 1);
+    }
+
+    if (luaL_loadbufferx(L, source.data(), source.size(), chunkName.c_str(), "t") != LUA_OK) {
+        std::string message = lua_tostring(L, -1);
+        lua_pop(L, 1);
+        throw AException(message);
+    }
+    writeCache(file, cacheDir, hash, dump(L));
+}
@@ -0,0 +1,73 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <clg.hpp>
+
+/**
+ * @brief Loads Lua form files, keeping an on-disk cache of their bytecode.
+ * @details
+ * Cache entries are named after the hash of the form's path and the hash of its source (which includes the Lua
+ * version and number types), so an edited form or a different Lua build never picks up stale bytecode: it is compiled
+ * from source and the cache entry is rewritten. The entry name starts with the form's file name, truncated, to be
+ * told apart by a human.
+ */
+class LuaChunkLoader {
+public:
+    /**
+     * @brief Pushes the compiled chunk of the file onto the stack.
+     * @param cacheDir bytecode cache directory; empty path disables the cache.
+     * @throws AException if the file could not be read or compiled.
+     */
+    static void load(lua_State* L, const std::filesystem::path& file, const std::filesystem::path& cacheDir);
+
+    /**
+     * @brief Reads and compiles the file into bytecode without touching the shared Lua state.
+     * @details
+     * Compilation happens in a private lua_State, so this is safe to call from a worker thread. The result is to be
+     * loaded with loadBytecode. The bytecode cache is used and updated the same way as in load.
+     * @param cacheDir bytecode cache directory; empty path disables the cache.
+     * @throws AException if the file could not be read or compiled.
+     */
+    static std::string compileFile(const std::filesystem::path& file, const std::filesystem::path& cacheDir);
+
+    /**
+     * @brief Compiles the source into bytecode in a private lua_State; safe to call from a worker thread.
+     * @throws AException if the source could not be compiled.
+     */
+    static std::string compile(std::string_view source, const std::string& chunkName);
+
+    /**
+     * @brief Pushes the function of bytecode produced by compile or compileFile onto the stack.
+     * @throws AException if the bytecode is invalid.
+     */
+    static void loadBytecode(lua_State* L, std::string_view bytecode, const std::string& chunkName);
+
+    /**
+     * @brief Hash of the source, salted with the Lua version and number representation.
+     */
+    static std::uint64_t sourceHash(std::string_view source) noexcept;
+
+    /**
+     * @brief Serializes the function on top of the stack with lua_dump.
+     */
+    static std::string dump(lua_State* L);
+
+    static std::filesystem::path cachePath(const std::filesystem::path& file, const std::filesystem::path& cacheDir, std::uint64_t hash);
+
+    static std::string readFile(const std::filesystem::path& file);
+
+    static void writeCache(const std::filesystem::path& file, const std::filesystem::path& cacheDir, std::uint64_t hash, std::string_view bytecode);
+};
@@ -0,0 +1,142 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include <uiengine/LuaGcPacer.h>
+#include <AUI/Thread/AThread.h>
+#include <algorithm>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace {
+    constexpr auto STATS_WINDOW = seconds(1);
+
+    /**
+     * @brief Heap size below which steps never run past the budget, KiB.
+     */
+    constexpr int MIN_FORCED_HEAP_KB = 1024;
+}
+
+LuaGcPacer::~LuaGcPacer() {
+    disable();
+}
+
+void LuaGcPacer::enable(Mode mode, microseconds budget) {
+#if LUA_VERSION_NUM >= 504
+    mGenerational = mode == Mode::GENERATIONAL;
+    if (mGenerational) {
+        lua_gc(mLua, LUA_GCGEN, 0, 0);
+    } else {
+        lua_gc(mLua, LUA_GCINC, 0, 0, 0);
+    }
+#else
+    // no generational collector before 5.4
+    mGenerational = false;
+#endif
+    lua_gc(mLua, LUA_GCSTOP, 0);
+    mEnabled = true;
+    mBudget = budget;
+    mLiveKb = lua_gc(mLua, LUA_GCCOUNT, 0);
+}
+
+void LuaGcPacer::disable() {
+    if (!mEnabled) {
+        return;
+    }
+    mEnabled = false;
+    lua_gc(mLua, LUA_GCRESTART, 0);
+}
+
+void LuaGcPacer::frameRendered() {
+    if (!mEnabled || mScheduled) {
+        return;
+    }
+    mScheduled = true;
+    AThread::current()->enqueue([this, guard = std::weak_ptr<char>(mGuard)] {
+        if (guard.expired()) {
+            return;
+        }
+        mScheduled = false;
+        step();
+    });
+}
+
+void LuaGcPacer::step() {
+    if (!mEnabled) {
+        return;
+    }
+    const auto start = Clock::now();
+    if (mGenerational) {
+        // a minor collection, or a major one if Lua decides so; LUA_GCSTEP never reports the end of a cycle here
+        lua_gc(mLua, LUA_GCSTEP, 0);
+        ++mCycles;
+        if (collectIfFallingBehind()) {
+            ++mCycles;
+        }
+    } else {
+        const auto deadline = start + mBudget;
+        bool cycleFinished = false;
+        do {
+            // both 5.3 and 5.4 let LUA_GCSTEP work while the collector is stopped, for the duration of the call
+            cycleFinished = lua_gc(mLua, LUA_GCSTEP, 0);
+        } while (!cycleFinished && Clock::now() < deadline);
+
+        if (cycleFinished) {
+            mLiveKb = lua_gc(mLua, LUA_GCCOUNT, 0);
+        }
+        if (cycleFinished || collectIfFallingBehind()) {
+            ++mCycles;
+        }
+    }
+    ++mSteps;
+    const auto end = Clock::now();
+    record(end, duration_cast<microseconds>(end - start));
+}
+
+bool LuaGcPacer::collectIfFallingBehind() {
+    if (lua_gc(mLua, LUA_GCCOUNT, 0) <= std::max(mLiveKb * 2, MIN_FORCED_HEAP_KB)) {
+        return false;
+    }
+    // falling behind the allocations; unbounded heap growth is worse than a long pause. A single call that always
+    // completes, unlike stepping until a cycle ends
+    lua_gc(mLua, LUA_GCCOLLECT, 0);
+    mLiveKb = lua_gc(mLua, LUA_GCCOUNT, 0);
+    return true;
+}
+
+void LuaGcPacer::record(Clock::time_point at, microseconds duration) {
+    mPauses.push_back({ at, duration });
+    while (!mPauses.empty() && at - mPauses.front().at > STATS_WINDOW) {
+        mPauses.pop_front();
+    }
+}
+
+LuaGcPacer::Stats LuaGcPacer::stats() const {
+    Stats result;
+    result.steps = mSteps;
+    result.cycles = mCycles;
+
+    const auto now = Clock::now();
+    std::vector<microseconds> pauses;
+    pauses.reserve(mPauses.size());
+    for (const auto& pause : mPauses) {
+        if (now - pause.at <= STATS_WINDOW) {
+            pauses.push_back(pause.duration);
+            result.totalPerSecond += pause.duration;
+        }
+    }
+    if (pauses.empty()) {
+        return result;
+    }
+    std::sort(pauses.begin(), pauses.end());
+    result.maxPause = pauses.back();
+    result.p99Pause = pauses[(pauses.size() - 1) * 99 / 100];
+    return result;
+}
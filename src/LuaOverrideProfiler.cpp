@@ -0,0 +1,109 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include <uiengine/LuaOverrideProfiler.h>
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace {
+    struct Registry {
+        std::mutex sync;
+        std::map<std::pair<std::string, std::string>, std::unique_ptr<LuaOverrideProfiler::Counter>, std::less<>> counters;
+    };
+
+    Registry& registry() {
+        static Registry r;
+        return r;
+    }
+
+    void appendJsonString(std::string& dst, std::string_view s) {
+        dst += '"';
+        for (char c : s) {
+            switch (c) {
+                case '"': dst += "\\\""; break;
+                case '\\': dst += "\\\\"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", unsigned(c));
+                        dst += buf;
+                    } else {
+                        dst += c;
+                    }
+            }
+        }
+        dst += '"';
+    }
+}
+
+LuaOverrideProfiler::Counter& LuaOverrideProfiler::counter(std::string_view className, std::string_view method) {
+    auto& r = registry();
+    std::unique_lock lock(r.sync);
+    auto& counter = r.counters[{ std::string(className), std::string(method) }];
+    if (!counter) {
+        counter = std::make_unique<Counter>();
+    }
+    return *counter;
+}
+
+std::vector<LuaOverrideProfiler::Entry> LuaOverrideProfiler::snapshot() {
+    std::vector<Entry> result;
+    {
+        auto& r = registry();
+        std::unique_lock lock(r.sync);
+        for (const auto& [key, counter] : r.counters) {
+            auto calls = counter->calls.load(std::memory_order_relaxed);
+            if (calls == 0) {
+                continue;
+            }
+            result.push_back({
+                .className = key.first,
+                .method = key.second,
+                .calls = calls,
+                .totalNs = counter->totalNs.load(std::memory_order_relaxed),
+                .maxNs = counter->maxNs.load(std::memory_order_relaxed),
+            });
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const Entry& a, const Entry& b) { return a.totalNs > b.totalNs; });
+    return result;
+}
+
+std::string LuaOverrideProfiler::toJson() {
+    std::string result = "[";
+    for (const auto& entry : snapshot()) {
+        if (result.size() > 1) {
+            result += ',';
+        }
+        result += "{\"class\":";
+        appendJsonString(result, entry.className);
+        result += ",\"method\":";
+        appendJsonString(result, entry.method);
+        result += ",\"calls\":" + std::to_string(entry.calls);
+        result += ",\"totalNs\":" + std::to_string(entry.totalNs);
+        result += ",\"maxNs\":" + std::to_string(entry.maxNs);
+        result += '}';
+    }
+    result += ']';
+    return result;
+}
+
+void LuaOverrideProfiler::reset() {
+    auto& r = registry();
+    std::unique_lock lock(r.sync);
+    for (const auto& [key, counter] : r.counters) {
+        counter->calls = 0;
+        counter->totalNs = 0;
+        counter->maxNs = 0;
+    }
+}
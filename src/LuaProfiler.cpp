@@ -0,0 +1,193 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include <uiengine/LuaProfiler.h>
+#include <AUI/Common/AException.h>
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace {
+    const void* profilerKey() noexcept {
+        static const char k = 0;
+        return &k;
+    }
+
+    const void* bindingNamesKey() noexcept {
+        static const char k = 0;
+        return &k;
+    }
+
+    /**
+     * @brief Pushes the function -> binding name table of the state, creating it if needed.
+     */
+    void pushBindingNames(lua_State* L) {
+        lua_rawgetp(L, LUA_REGISTRYINDEX, bindingNamesKey());
+        if (lua_istable(L, -1)) {
+            return;
+        }
+        lua_pop(L, 1);
+        lua_createtable(L, 0, 0);
+        lua_pushvalue(L, -1);
+        lua_rawsetp(L, LUA_REGISTRYINDEX, bindingNamesKey());
+    }
+
+    /**
+     * @brief Stack depth recorded per sample; deeper frames are dropped from the root side.
+     */
+    constexpr int MAX_DEPTH = 128;
+
+    std::string frameName(lua_Debug& ar, const char* binding) {
+        std::string result;
+        if (*ar.what == 'C') {
+            result = "[C] ";
+            result += binding ? binding : ar.name ? ar.name : "?";
+            std::replace(result.begin(), result.end(), ';', ',');
+            return result;
+        }
+        if (*ar.what == 'm') {
+            result = "main chunk";
+        } else {
+            result = ar.name ? ar.name : "?";
+        }
+        result += " (";
+        result += ar.short_src;
+        result += ':';
+        result += std::to_string(ar.linedefined);
+        result += ')';
+        // ';' separates frames in the folded format
+        std::replace(result.begin(), result.end(), ';', ',');
+        return result;
+    }
+}
+
+LuaProfiler::~LuaProfiler() {
+    stop();
+}
+
+void LuaProfiler::start(std::chrono::microseconds interval, int instructionCount) {
+    lua_rawgetp(mLua, LUA_REGISTRYINDEX, profilerKey());
+    auto running = lua_touserdata(mLua, -1);
+    lua_pop(mLua, 1);
+    if (running != nullptr && running != this) {
+        throw AException("another profiler is already running on this Lua state");
+    }
+    mInterval = interval;
+    mNextSample = std::chrono::steady_clock::now() + mInterval;
+    lua_pushlightuserdata(mLua, this);
+    lua_rawsetp(mLua, LUA_REGISTRYINDEX, profilerKey());
+    lua_sethook(mLua, hook, LUA_MASKCOUNT, std::max(instructionCount, 1));
+    mRunning = true;
+}
+
+void LuaProfiler::stop() {
+    if (!mRunning) {
+        return;
+    }
+    mRunning = false;
+    lua_sethook(mLua, nullptr, 0, 0);
+    lua_pushnil(mLua);
+    lua_rawsetp(mLua, LUA_REGISTRYINDEX, profilerKey());
+}
+
+void LuaProfiler::nameBindings(lua_State* L, std::string_view className) {
+    if (!lua_istable(L, -1)) {
+        return;
+    }
+    clg::stack_integrity_check check(L);
+    lua_pushnil(L);
+    while (lua_next(L, -2)) {
+        // keys are checked by type: lua_tolstring would convert a number key in place and break lua_next
+        if (lua_type(L, -2) == LUA_TSTRING && lua_iscfunction(L, -1)) {
+            std::string name(className);
+            name += ':';
+            name += lua_tostring(L, -2);
+            nameBinding(L, name);
+        }
+        lua_pop(L, 1);
+    }
+}
+
+void LuaProfiler::nameBinding(lua_State* L, std::string_view name) {
+    if (!lua_iscfunction(L, -1)) {
+        return;
+    }
+    clg::stack_integrity_check check(L);
+    pushBindingNames(L);
+    lua_pushvalue(L, -2);
+    lua_pushlstring(L, name.data(), name.size());
+    lua_rawset(L, -3);
+    lua_pop(L, 1);
+}
+
+void LuaProfiler::reset() {
+    mStacks.clear();
+    mSampleCount = 0;
+}
+
+void LuaProfiler::hook(lua_State* L, lua_Debug*) {
+    lua_rawgetp(L, LUA_REGISTRYINDEX, profilerKey());
+    auto self = static_cast<LuaProfiler*>(lua_touserdata(L, -1));
+    lua_pop(L, 1);
+    if (self == nullptr || !self->mRunning) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now < self->mNextSample) {
+        return;
+    }
+    self->mNextSample = now + self->mInterval;
+    self->sample(L);
+}
+
+void LuaProfiler::sample(lua_State* L) {
+    std::vector<std::string> frames;
+    lua_Debug ar;
+    lua_rawgetp(L, LUA_REGISTRYINDEX, bindingNamesKey());
+    for (int level = 0; level < MAX_DEPTH && lua_getstack(L, level, &ar); ++level) {
+        // "f" pushes the running function, which identifies the binding
+        lua_getinfo(L, "Snf", &ar);
+        if (*ar.what == 'C' && lua_istable(L, -2)) {
+            lua_rawget(L, -2);
+        }
+        frames.push_back(frameName(ar, lua_type(L, -1) == LUA_TSTRING ? lua_tostring(L, -1) : nullptr));
+        lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+
+    std::string stack;
+    for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+        if (!stack.empty()) {
+            stack += ';';
+        }
+        stack += *it;
+    }
+    ++mStacks[std::move(stack)];
+    ++mSampleCount;
+}
+
+std::string LuaProfiler::folded() const {
+    std::vector<std::pair<std::string_view, std::size_t>> stacks(mStacks.begin(), mStacks.end());
+    std::sort(stacks.begin(), stacks.end());
+    std::string result;
+    for (const auto& [stack, count] : stacks) {
+        result += stack;
+        result += ' ';
+        result += std::to_string(count);
+        result += '\n';
+    }
+    return result;
+}
+
+bool LuaProfiler::writeFolded(const std::filesystem::path& path) const {
+    std::ofstream fos(path, std::ios::binary | std::ios::trunc);
+    fos << folded();
+    return bool(fos);
+}
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "clg.hpp"
+#include <uiengine/ILuaExposedView.h>
 
 class LuaSelfAccessor {
 public:
@@ -24,7 +25,7 @@ public:
             return mAsLuaSelf;
         }
 
-        return mAsLuaSelf = dynamic_cast<clg::lua_self*>(self);
+        return mAsLuaSelf = ILuaExposedView::fromView(self);
     }
 
 private:
@@ -0,0 +1,363 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include <uiengine/LuaVec.h>
+#include <uiengine/Converters.h>
+#include "lauxlib.h"
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace {
+    const void* metatableKey() noexcept {
+        static const char k = 0;
+        return &k;
+    }
+
+    bool isWhole(lua_Number v) noexcept {
+        return std::isfinite(v) && v == std::floor(v) &&
+               v >= lua_Number(std::numeric_limits<lua_Integer>::min()) &&
+               v <= lua_Number(std::numeric_limits<lua_Integer>::max());
+    }
+
+    void pushComponent(lua_State* l, const LuaVec::Value& v, int index) {
+        auto c = v.components[index];
+        if (v.integral && isWhole(c)) {
+            lua_pushinteger(l, lua_Integer(c));
+        } else {
+            lua_pushnumber(l, c);
+        }
+    }
+
+    /**
+     * @return component index of the key at stack index n (0-based), or -1.
+     */
+    int componentIndex(lua_State* l, int n, const LuaVec::Value& v) {
+        int index = -1;
+        if (lua_type(l, n) == LUA_TNUMBER) {
+            int isInteger = 0;
+            auto i = lua_tointegerx(l, n, &isInteger);
+            if (isInteger) {
+                index = int(i) - 1;
+            }
+        } else if (lua_type(l, n) == LUA_TSTRING) {
+            std::size_t length = 0;
+            const char* s = lua_tolstring(l, n, &length);
+            if (length == 1) {
+                switch (s[0]) {
+                    case 'x': index = 0; break;
+                    case 'y': index = 1; break;
+                    case 'z': index = 2; break;
+                    case 'w': index = 3; break;
+                }
+            }
+        }
+        if (index < 0 || index >= v.size) {
+            return -1;
+        }
+        return index;
+    }
+
+    LuaVec::Value& self(lua_State* l) {
+        return *static_cast<LuaVec::Value*>(lua_touserdata(l, 1));
+    }
+
+    int vecIndex(lua_State* l) {
+        auto& v = self(l);
+        auto i = componentIndex(l, 2, v);
+        if (i < 0) {
+            lua_pushnil(l);
+            return 1;
+        }
+        pushComponent(l, v, i);
+        return 1;
+    }
+
+    int vecNewIndex(lua_State* l) {
+        auto& v = self(l);
+        auto i = componentIndex(l, 2, v);
+        if (i < 0) {
+            return luaL_error(l, "vec%d has no component %s", int(v.size), luaL_tolstring(l, 2, nullptr));
+        }
+        v.components[i] = luaL_checknumber(l, 3);
+        v.integral = v.integral && lua_isinteger(l, 3);
+        return 0;
+    }
+
+    /**
+     * @brief Operand of an arithmetic metamethod: either a vector or a number broadcast to the other operand's size.
+     */
+    struct Operand {
+        LuaVec::Value value;
+        bool scalar = false;
+    };
+
+    Operand operand(lua_State* l, int n) {
+        Operand result;
+        if (LuaVec::get(l, n, result.value)) {
+            return result;
+        }
+        int isNumber = 0;
+        auto number = lua_tonumberx(l, n, &isNumber);
+        if (!isNumber) {
+            luaL_error(l, "vec arithmetic: expected vec or number, got %s", luaL_typename(l, n));
+        }
+        result.scalar = true;
+        result.value.integral = lua_isinteger(l, n);
+        for (auto& c : result.value.components) {
+            c = number;
+        }
+        return result;
+    }
+
+    template<typename Op>
+    int arithmetic(lua_State* l, bool keepsIntegral, Op&& op) {
+        auto a = operand(l, 1);
+        auto b = operand(l, 2);
+        if (!a.scalar && !b.scalar && a.value.size != b.value.size) {
+            return luaL_error(l, "vec arithmetic: size mismatch (vec%d and vec%d)", int(a.value.size), int(b.value.size));
+        }
+        LuaVec::Value result;
+        result.size = a.scalar ? b.value.size : a.value.size;
+        result.integral = keepsIntegral && a.value.integral && b.value.integral;
+        for (int i = 0; i < result.size; ++i) {
+            if constexpr (std::is_invocable_v<Op, lua_Number, lua_Number, bool>) {
+                result.components[i] = op(a.value.components[i], b.value.components[i], result.integral);
+            } else {
+                result.components[i] = op(a.value.components[i], b.value.components[i]);
+            }
+        }
+        LuaVec::push(l, result);
+        return 1;
+    }
+
+    int vecAdd(lua_State* l) {
+        return arithmetic(l, true, [](lua_Number a, lua_Number b) { return a + b; });
+    }
+
+    int vecSub(lua_State* l) {
+        return arithmetic(l, true, [](lua_Number a, lua_Number b) { return a - b; });
+    }
+
+    int vecMul(lua_State* l) {
+        return arithmetic(l, true, [](lua_Number a, lua_Number b) { return a * b; });
+    }
+
+    int vecDiv(lua_State* l) {
+        return arithmetic(l, false, [](lua_Number a, lua_Number b) { return a / b; });
+    }
+
+    int vecIdiv(lua_State* l) {
+        return arithmetic(l, true, [l](lua_Number a, lua_Number b, bool integral) {
+            if (integral && b == 0) {
+                // same as integer // of Lua
+                luaL_error(l, "attempt to perform 'n//0'");
+            }
+            return std::floor(a / b);
+        });
+    }
+
+    int vecUnm(lua_State* l) {
+        auto result = self(l);
+        for (auto& c : result.components) {
+            c = -c;
+        }
+        LuaVec::push(l, result);
+        return 1;
+    }
+
+    int vecEq(lua_State* l) {
+        LuaVec::Value a, b;
+        bool equal = LuaVec::get(l, 1, a) && LuaVec::get(l, 2, b) && a.size == b.size;
+        for (int i = 0; equal && i < a.size; ++i) {
+            equal = a.components[i] == b.components[i];
+        }
+        lua_pushboolean(l, equal);
+        return 1;
+    }
+
+    int vecNext(lua_State* l) {
+        auto& v = self(l);
+        auto i = luaL_checkinteger(l, 2);
+        if (i < 0 || i >= v.size) {
+            lua_pushnil(l);
+            return 1;
+        }
+        lua_pushinteger(l, i + 1);
+        pushComponent(l, v, int(i));
+        return 2;
+    }
+
+    /**
+     * @brief pairs(v) iterates the components as pairs of a table would: 1, x; 2, y; ...
+     */
+    int vecPairs(lua_State* l) {
+        lua_pushcfunction(l, vecNext);
+        lua_pushvalue(l, 1);
+        lua_pushinteger(l, 0);
+        return 3;
+    }
+
+    int vecLen(lua_State* l) {
+        lua_pushinteger(l, self(l).size);
+        return 1;
+    }
+
+    int vecToString(lua_State* l) {
+        auto& v = self(l);
+        std::string result = "vec" + std::to_string(v.size) + "(";
+        for (int i = 0; i < v.size; ++i) {
+            if (i != 0) {
+                result += ", ";
+            }
+            char buf[32];
+            auto c = v.components[i];
+            if (v.integral && isWhole(c)) {
+                std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(c));
+            } else {
+                std::snprintf(buf, sizeof(buf), "%.14g", double(c));
+            }
+            result += buf;
+        }
+        result += ")";
+        lua_pushlstring(l, result.data(), result.size());
+        return 1;
+    }
+
+    void pushMetatable(lua_State* l) {
+        if (lua_rawgetp(l, LUA_REGISTRYINDEX, metatableKey()) == LUA_TTABLE) {
+            return;
+        }
+        lua_pop(l, 1);
+
+        static constexpr luaL_Reg METAMETHODS[] = {
+            { "__index", vecIndex },
+            { "__newindex", vecNewIndex },
+            { "__add", vecAdd },
+            { "__sub", vecSub },
+            { "__mul", vecMul },
+            { "__div", vecDiv },
+            { "__idiv", vecIdiv },
+            { "__unm", vecUnm },
+            { "__eq", vecEq },
+            { "__len", vecLen },
+            { "__pairs", vecPairs },
+            { "__tostring", vecToString },
+            { nullptr, nullptr },
+        };
+        lua_createtable(l, 0, int(std::size(METAMETHODS)) - 1);
+        luaL_setfuncs(l, METAMETHODS, 0);
+        lua_pushvalue(l, -1);
+        lua_rawsetp(l, LUA_REGISTRYINDEX, metatableKey());
+    }
+
+    template<int N>
+    int construct(lua_State* l) {
+        LuaVec::Value result;
+        result.size = N;
+        int argc = lua_gettop(l);
+        if (argc == 1 && (lua_type(l, 1) == LUA_TTABLE || lua_type(l, 1) == LUA_TUSERDATA)) {
+            result.integral = true;
+            for (int i = 0; i < N; ++i) {
+                lua_geti(l, 1, i + 1);
+                int isNumber = 0;
+                result.components[i] = lua_tonumberx(l, -1, &isNumber);
+                if (!isNumber) {
+                    return luaL_argerror(l, 1, "expected table or vec of numbers");
+                }
+                result.integral = result.integral && lua_isinteger(l, -1);
+                lua_pop(l, 1);
+            }
+        } else if (argc == 1) {
+            auto s = luaL_checknumber(l, 1);
+            result.integral = lua_isinteger(l, 1);
+            for (int i = 0; i < N; ++i) {
+                result.components[i] = s;
+            }
+        } else {
+            result.integral = true;
+            for (int i = 0; i < N; ++i) {
+                result.components[i] = luaL_checknumber(l, i + 1);
+                result.integral = result.integral && lua_isinteger(l, i + 1);
+            }
+        }
+        LuaVec::push(l, result);
+        return 1;
+    }
+
+    template<int N>
+    std::optional<glm::vec<N, float>> fromLua(lua_State* l, int n) {
+        auto r = clg::get_from_lua_raw<glm::vec<N, float>>(l, n);
+        if (r.is_error()) {
+            return std::nullopt;
+        }
+        return *r;
+    }
+}
+
+void LuaVec::push(lua_State* l, const Value& value) {
+#if LUA_VERSION_NUM >= 504
+    auto data = static_cast<Value*>(lua_newuserdatauv(l, sizeof(Value), 0));
+#else
+    auto data = static_cast<Value*>(lua_newuserdata(l, sizeof(Value)));
+#endif
+    *data = value;
+    pushMetatable(l);
+    lua_setmetatable(l, -2);
+}
+
+bool LuaVec::get(lua_State* l, int n, Value& out) {
+    if (lua_type(l, n) != LUA_TUSERDATA || !lua_getmetatable(l, n)) {
+        return false;
+    }
+    lua_rawgetp(l, LUA_REGISTRYINDEX, metatableKey());
+    bool isVec = lua_rawequal(l, -1, -2);
+    lua_pop(l, 2);
+    if (!isVec) {
+        return false;
+    }
+    out = *static_cast<const Value*>(lua_touserdata(l, n));
+    return true;
+}
+
+void LuaVec::registerConstructors(lua_State* l) {
+    lua_register(l, "vec2", construct<2>);
+    lua_register(l, "vec3", construct<3>);
+    lua_register(l, "vec4", construct<4>);
+}
+
+std::optional<glm::vec2> vec2_from_lua(lua_State* l, int n) {
+    return fromLua<2>(l, n);
+}
+
+std::optional<glm::vec3> vec3_from_lua(lua_State* l, int n) {
+    return fromLua<3>(l, n);
+}
+
+std::optional<glm::vec4> vec4_from_lua(lua_State* l, int n) {
+    return fromLua<4>(l, n);
+}
+
+int vec2_to_lua(lua_State* l, glm::vec2 v) {
+    return clg::push_to_lua(l, v);
+}
+
+int vec3_to_lua(lua_State* l, glm::vec3 v) {
+    return clg::push_to_lua(l, v);
+}
+
+int vec4_to_lua(lua_State* l, glm::vec4 v) {
+    return clg::push_to_lua(l, v);
+}
@@ -0,0 +1,56 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ * @details
+ * An empty or missing file results in an invalid mapping (operator bool returns false).
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]]
+    const char* data() const noexcept {
+        return mData;
+    }
+
+    [[nodiscard]]
+    std::size_t size() const noexcept {
+        return mSize;
+    }
+
+    [[nodiscard]]
+    std::string_view view() const noexcept {
+        return { mData, mSize };
+    }
+
+    explicit operator bool() const noexcept {
+        return mData != nullptr;
+    }
+
+private:
+    const char* mData = nullptr;
+    std::size_t mSize = 0;
+#if AUI_PLATFORM_WIN
+    void* mFile = nullptr;
+    void* mMapping = nullptr;
+#endif
+};
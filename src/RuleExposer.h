@@ -12,6 +12,7 @@
 
 #include "clg.hpp"
 #include "fake_return.h"
+#include "RuleInterning.h"
 #include <uiengine/UIEngine.h>
 
 
@@ -21,15 +22,36 @@ struct RuleExposer {
 public:
 
 
+    /**
+     * @brief Registers a constructor of the rule.
+     * @details
+     * When all arguments are plain values (see RuleInternKey), calls with equal arguments return the same interned
+     * property instance.
+     */
     template<typename... Args>
     RuleExposer& ctor() {
-        auto callback = [&uiEngine = mUiEngine](Args... args) -> std::shared_ptr<ass::prop::IPropertyBase> {
-            return std::make_shared<ass::prop::Property<Rule>>(Rule{std::move(args)...});
+        static constexpr bool INTERNABLE = (RuleInternKey<std::decay_t<Args>>::SUPPORTED && ...);
+        auto callback = [&uiEngine = mUiEngine, interned = std::make_shared<RuleInternTable>()](Args... args) -> std::shared_ptr<ass::prop::IPropertyBase> {
+            if constexpr (INTERNABLE) {
+                std::string key;
+                (RuleInternKey<std::decay_t<Args>>::append(key, args), ...);
+                auto& stats = uiEngine.ruleInterningStats();
+                if (auto property = interned->find(key)) {
+                    ++stats.hits;
+                    return property;
+                }
+                ++stats.misses;
+                std::shared_ptr<ass::prop::IPropertyBase> property = std::make_shared<ass::prop::Property<Rule>>(Rule{std::move(args)...});
+                interned->insert(std::move(key), property);
+                return property;
+            } else {
+                return std::make_shared<ass::prop::Property<Rule>>(Rule{std::move(args)...});
+            }
         };
         if (mExtraConstructors == nullptr) {
-            mExtraConstructors = &clg::state_interface(clg::state()).register_function_overloaded(mName, std::move(callback));
+            mExtraConstructors = &clg::state_interface(mUiEngine.luaState()).register_function_overloaded(mName, std::move(callback));
         } else {
-            mExtraConstructors->push_back(clg::state_interface(clg::state()).wrap_lambda_to_cfunction_for_overloading(std::move(callback), mName));
+            mExtraConstructors->push_back(clg::state_interface(mUiEngine.luaState()).wrap_lambda_to_cfunction_for_overloading(std::move(callback), mName));
         }
 
         return *this;
@@ -0,0 +1,148 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#pragma once
+
+#include <AUI/ASS/ASS.h>
+#include <AUI/Common/AColor.h>
+#include <AUI/Common/AString.h>
+#include <AUI/Util/AMetric.h>
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+/**
+ * @brief Byte representation of a RuleExposer constructor argument, for types whose value is fully described by it.
+ * @details
+ * Arguments of other types (tables, views, functions) make the constructor call non-internable.
+ */
+template<typename T, typename = void>
+struct RuleInternKey {
+    static constexpr bool SUPPORTED = false;
+};
+
+template<typename T>
+struct RuleInternKey<T, std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>> {
+    static constexpr bool SUPPORTED = true;
+
+    static void append(std::string& key, T value) {
+        key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+};
+
+template<>
+struct RuleInternKey<std::nullptr_t> {
+    static constexpr bool SUPPORTED = true;
+
+    static void append(std::string&, std::nullptr_t) {}
+};
+
+template<>
+struct RuleInternKey<std::string_view> {
+    static constexpr bool SUPPORTED = true;
+
+    static void append(std::string& key, std::string_view value) {
+        RuleInternKey<std::size_t>::append(key, value.size());
+        key.append(value);
+    }
+};
+
+template<>
+struct RuleInternKey<std::string>: RuleInternKey<std::string_view> {};
+
+template<>
+struct RuleInternKey<AString> {
+    static constexpr bool SUPPORTED = true;
+
+    static void append(std::string& key, const AString& value) {
+        RuleInternKey<std::string_view>::append(key, value.toStdString());
+    }
+};
+
+template<>
+struct RuleInternKey<AMetric> {
+    static constexpr bool SUPPORTED = true;
+
+    static void append(std::string& key, const AMetric& value) {
+        RuleInternKey<float>::append(key, value.getRawValue());
+        RuleInternKey<AMetric::Unit>::append(key, value.getUnit());
+    }
+};
+
+template<>
+struct RuleInternKey<AColor> {
+    static constexpr bool SUPPORTED = true;
+
+    static void append(std::string& key, const AColor& value) {
+        for (int i = 0; i < 4; ++i) {
+            RuleInternKey<float>::append(key, value[i]);
+        }
+    }
+};
+
+template<int N, typename T, glm::qualifier Q>
+struct RuleInternKey<glm::vec<N, T, Q>> {
+    static constexpr bool SUPPORTED = RuleInternKey<T>::SUPPORTED;
+
+    static void append(std::string& key, const glm::vec<N, T, Q>& value) {
+        for (int i = 0; i < N; ++i) {
+            RuleInternKey<T>::append(key, value[i]);
+        }
+    }
+};
+
+template<typename T>
+struct RuleInternKey<ass::unset_wrap<T>> {
+    static constexpr bool SUPPORTED = RuleInternKey<T>::SUPPORTED;
+
+    static void append(std::string& key, const ass::unset_wrap<T>& value) {
+        RuleInternKey<bool>::append(key, bool(value));
+        if (value) {
+            RuleInternKey<T>::append(key, *value);
+        }
+    }
+};
+
+/**
+ * @brief Interned properties produced by a single RuleExposer constructor.
+ * @details
+ * Properties are immutable once constructed, so calls with equal arguments share one instance. Entries do not keep
+ * properties alive; expired entries are swept as the table grows.
+ */
+class RuleInternTable {
+public:
+    using Property = std::shared_ptr<ass::prop::IPropertyBase>;
+
+    /**
+     * @return interned property for the key; nullptr if none is alive.
+     */
+    [[nodiscard]]
+    Property find(const std::string& key) const {
+        if (auto it = mEntries.find(key); it != mEntries.end()) {
+            return it->second.lock();
+        }
+        return nullptr;
+    }
+
+    void insert(std::string key, const Property& property) {
+        if (mEntries.size() >= mSweepThreshold) {
+            std::erase_if(mEntries, [](const auto& entry) { return entry.second.expired(); });
+            mSweepThreshold = std::max<std::size_t>(64, mEntries.size() * 2);
+        }
+        mEntries[std::move(key)] = property;
+    }
+
+private:
+    std::unordered_map<std::string, std::weak_ptr<ass::prop::IPropertyBase>> mEntries;
+    std::size_t mSweepThreshold = 64;
+};
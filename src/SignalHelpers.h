@@ -49,31 +49,21 @@ namespace {
             }
 
             template<typename ViewType>
-            static void connectLuaSelf(const _<ViewType>& self, const ASignal<Args...>& signal, const clg::function& callback, const _<clg::lua_self>& luaSelf) {
-                auto id = clg::light_userdata{const_cast<void*>(reinterpret_cast<const void*>(&signal))};
-                auto callbacks = luaSelf->luaDataHolder().get_or_create(id, [&]() {
-                    AObject::connect(signal, self, [self = self.get(), luaSelf = luaSelf.get(), id](Args... args) {
-                        auto table = luaSelf->luaDataHolder()[id].as<clg::table_view>();
-                        size_t cnt = table.raw_len();
-                        for (size_t i = 1; i <= cnt;) {
-                            auto func = table[i].ref();
-                            if (func.isFunction()) {
-                                auto result = clg::function(std::move(func)).call<std::optional<clg::ref>>(aui::ptr::shared_from_this(self), std::move(args)...);
-                                if (result) {
-                                    static auto SIGNAL_REMOVE = clg::state_interface(ExposeHelper::state()).global_variable("SIGNAL_REMOVE");
-                                    if (*result == SIGNAL_REMOVE) {
-                                        table.raw_set(i, nullptr, ExposeHelper::state());
-                                        cnt -= 1;
-                                        continue;
-                                    }
-                                }
+            static void connectLuaSelf(const _<ViewType>& self, const ASignal<Args...>& signal, const clg::function& callback, ILuaExposedView* luaSelf) {
+                auto [handlers, created] = luaSelf->signalHandlers(&signal);
+                if (created) {
+                    AObject::connect(signal, self, [self = self.get(), handlers = &handlers, &uiEngine = luaSelf->uiEngine()](Args... args) {
+                        auto selfPtr = aui::ptr::shared_from_this(self);
+                        handlers->dispatch([&](clg::function& func) {
+                            auto result = func.call<std::optional<clg::ref>>(selfPtr, args...);
+                            if (!result) {
+                                return false;
                             }
-                            ++i;
-                        }
+                            return *result == uiEngine.signalRemove();
+                        });
                     });
-                    return clg::table{};
-                }).template as<clg::table_view>();
-                callbacks[callbacks.raw_len() + 1] = callback;
+                }
+                handlers.add(callback);
             }
         };
     }
@@ -84,7 +74,7 @@ struct ForwardSignal {
     clg::builder_return_type operator()(const _<ViewType>& self, const clg::function& callback) {
         const auto& signal = signal::getSignal<signalField>(self);
         using Deducer = typename signal::ArgumentDeducer<std::decay_t<decltype(signal)>>;
-        if (auto luaSelf = _cast<clg::lua_self>(self)) {
+        if (auto luaSelf = ILuaExposedView::fromView(self.get())) {
             Deducer::connectLuaSelf(self, signal, callback, luaSelf);
         } else {
             Deducer::connect(self, signal, callback);
@@ -97,12 +87,9 @@ template<auto signalField, typename ViewType = AView>
 struct DropSignal {
     clg::builder_return_type operator()(const _<ViewType>& self) {
         const auto& signal = signal::getSignal<signalField>(self);
-        if (auto luaSelf = _cast<clg::lua_self>(self)) {
-            auto id = clg::light_userdata{const_cast<void*>(reinterpret_cast<const void*>(&signal))};
-            auto holder = luaSelf->luaDataHolder();
-            auto value = holder[id];
-            if (!value.ref().isNull()) {
-                value = clg::table{};
+        if (auto luaSelf = ILuaExposedView::fromView(self.get())) {
+            if (auto handlers = luaSelf->findSignalHandlers(&signal)) {
+                handlers->clear();
             }
         }
         else {
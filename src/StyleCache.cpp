@@ -0,0 +1,243 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#include "StyleCache.h"
+#include "StyleHelper.h"
+#include "lauxlib.h"
+#include <AUI/Util/ARaiiHelper.h>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace ass;
+
+namespace {
+    using Holder = _<const StyleCache::Compiled>;
+
+    constexpr int MAX_SIGNATURE_DEPTH = 32;
+
+    const void* cacheKey() noexcept {
+        static const char k = 0;
+        return &k;
+    }
+
+    int holderGc(lua_State* L) {
+        std::destroy_at(static_cast<Holder*>(lua_touserdata(L, 1)));
+        return 0;
+    }
+
+    /**
+     * @brief Pushes the weak-keyed table mapping style tables to compiled styles.
+     */
+    void pushCacheTable(lua_State* L) {
+        if (lua_rawgetp(L, LUA_REGISTRYINDEX, cacheKey()) == LUA_TTABLE) {
+            return;
+        }
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_createtable(L, 0, 1);
+        lua_pushliteral(L, "k");
+        lua_setfield(L, -2, "__mode");
+        lua_setmetatable(L, -2);
+        lua_pushvalue(L, -1);
+        lua_rawsetp(L, LUA_REGISTRYINDEX, cacheKey());
+    }
+
+    void pushHolder(lua_State* L, Holder compiled) {
+#if LUA_VERSION_NUM >= 504
+        new (lua_newuserdatauv(L, sizeof(Holder), 0)) Holder(std::move(compiled));
+#else
+        new (lua_newuserdata(L, sizeof(Holder))) Holder(std::move(compiled));
+#endif
+        if (luaL_newmetatable(L, "UIEngine.StyleCacheEntry")) {
+            lua_pushcfunction(L, holderGc);
+            lua_setfield(L, -2, "__gc");
+        }
+        lua_setmetatable(L, -2);
+    }
+
+    std::string signature(lua_State* L, int n, int depth);
+
+    void appendPointer(std::string& dst, char tag, const void* ptr) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%c%p", tag, ptr);
+        dst += buf;
+    }
+
+    /**
+     * @brief Appends the value at absolute stack index n without converting it in place (keys of lua_next must stay
+     * intact).
+     */
+    void appendValue(lua_State* L, int n, std::string& dst, int depth) {
+        switch (lua_type(L, n)) {
+            case LUA_TBOOLEAN:
+                dst += lua_toboolean(L, n) ? "b1" : "b0";
+                return;
+
+            case LUA_TNUMBER: {
+                char buf[48];
+                if (lua_isinteger(L, n)) {
+                    std::snprintf(buf, sizeof(buf), "i%lld", static_cast<long long>(lua_tointeger(L, n)));
+                } else {
+                    std::snprintf(buf, sizeof(buf), "n%a", double(lua_tonumber(L, n)));
+                }
+                dst += buf;
+                return;
+            }
+
+            case LUA_TSTRING: {
+                std::size_t length = 0;
+                const char* s = lua_tolstring(L, n, &length);
+                dst += 's';
+                dst += std::to_string(length);
+                dst += ':';
+                dst.append(s, length);
+                return;
+            }
+
+            case LUA_TTABLE:
+                if (depth < MAX_SIGNATURE_DEPTH) {
+                    dst += signature(L, n, depth);
+                    return;
+                }
+                break;
+
+            case LUA_TUSERDATA:
+                if (auto property = clg::get_from_lua_raw<std::shared_ptr<ass::prop::IPropertyBase>>(L, n); !property.is_error()) {
+                    // the compiled style holds the property, so its address is not reused while the entry is alive
+                    appendPointer(dst, 'p', property->get());
+                    return;
+                }
+                break;
+        }
+        appendPointer(dst, 'r', lua_topointer(L, n));
+    }
+
+    std::string signature(lua_State* L, int n, int depth) {
+        n = lua_absindex(L, n);
+        std::vector<std::string> entries;
+        lua_pushnil(L);
+        while (lua_next(L, n)) {
+            std::string entry;
+            appendValue(L, lua_absindex(L, -2), entry, depth + 1);
+            entry += '=';
+            appendValue(L, lua_absindex(L, -1), entry, depth + 1);
+            entries.push_back(std::move(entry));
+            lua_pop(L, 1);
+        }
+        // lua_next order depends on the table's history, not only on its contents
+        std::sort(entries.begin(), entries.end());
+
+        std::string result = "{";
+        for (const auto& entry : entries) {
+            result += entry;
+            result += ';';
+        }
+        result += '}';
+        return result;
+    }
+}
+
+bool StyleCache::isEmpty(const clg::ref& table) const {
+    if (table.isNull()) {
+        return true;
+    }
+    auto L = mLua;
+    clg::stack_integrity_check check(L);
+    table.push_value_to_stack(L);
+    if (!lua_istable(L, -1)) {
+        lua_pop(L, 1);
+        return false;
+    }
+    lua_pushnil(L);
+    bool empty = true;
+    if (lua_next(L, -2)) {
+        empty = false;
+        lua_pop(L, 2);
+    }
+    lua_pop(L, 1);
+    return empty;
+}
+
+_<const StyleCache::Compiled> StyleCache::get(const clg::ref& table) {
+    auto L = mLua;
+    clg::stack_integrity_check check(L);
+    pushCacheTable(L);            // cache
+    table.push_value_to_stack(L); // cache, table
+    ARaiiHelper pop = [&] {
+        lua_pop(L, 2);
+    };
+
+    lua_pushvalue(L, -1);
+    if (lua_rawget(L, -3) == LUA_TUSERDATA) {
+        auto result = *static_cast<Holder*>(lua_touserdata(L, -1));
+        lua_pop(L, 1);
+        return result;
+    }
+    lua_pop(L, 1);
+
+    auto compiled = mStructuralHashing ? getStructural(L, table) : compile(table);
+
+    lua_pushvalue(L, -1);         // cache, table, table
+    pushHolder(L, compiled);      // cache, table, table, holder
+    lua_rawset(L, -4);            // cache, table
+    return compiled;
+}
+
+void StyleCache::invalidate(const clg::ref& table) {
+    auto L = mLua;
+    clg::stack_integrity_check check(L);
+    pushCacheTable(L);
+    table.push_value_to_stack(L);
+    if (lua_istable(L, -1)) {
+        lua_pushnil(L);
+        lua_rawset(L, -3);
+        lua_pop(L, 1);
+    } else {
+        lua_pop(L, 2);
+    }
+}
+
+_<const StyleCache::Compiled> StyleCache::getStructural(lua_State* L, const clg::ref& table) {
+    auto sig = signature(L, -1);
+    if (auto it = mStructuralEntries.find(sig); it != mStructuralEntries.end()) {
+        return it->second;
+    }
+    auto compiled = compile(table);
+    if (mStructuralEntries.size() >= mSweepThreshold) {
+        // drop entries referenced neither by a live style table nor by a view
+        std::erase_if(mStructuralEntries, [](const auto& entry) {
+            const auto& c = entry.second;
+            return c.use_count() == 1 && (!c->stylesheet || c->stylesheet.use_count() == 1);
+        });
+        mSweepThreshold = std::max<std::size_t>(64, mStructuralEntries.size() * 2);
+    }
+    mStructuralEntries[std::move(sig)] = compiled;
+    return compiled;
+}
+
+_<const StyleCache::Compiled> StyleCache::compile(const clg::ref& table) const {
+    auto t = table.as<clg::table>();
+    auto result = std::make_shared<Compiled>();
+    StyleHelper sh(mLua);
+    if (!sh.processDeclaration(t)) {
+        StyleHelper::processDeclarations(result->customStyle, t.toArray());
+        return result;
+    }
+    auto stylesheet = _new<AStylesheet>(AStylesheet(std::initializer_list<Rule>{}));
+    stylesheet->setRules(std::move(static_cast<AVector<Rule>&>(sh.rules())));
+    result->stylesheet = std::move(stylesheet);
+    return result;
+}
+
+std::string StyleCache::signature(lua_State* L, int n) {
+    return ::signature(L, n, 0);
+}
@@ -0,0 +1,89 @@
+// AUI Framework - Declarative UI toolkit for modern C++20
+// Copyright (C) 2020-2025 Alex2772 and Contributors
+//
+// SPDX-License-Identifier: MPL-2.0
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+
+#pragma once
+
+#include <clg.hpp>
+#include <AUI/ASS/ASS.h>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Cache of compiled setStyle tables.
+ * @details
+ * Compiled styles are keyed by the identity of the Lua table (in a weak-keyed registry table, so the entry dies with
+ * the table). Therefore, modifications of a style table after it was passed to setStyle are not picked up until the
+ * table is invalidated (UI.invalidateStyle(table)); views styled with it keep their style until setStyle is called
+ * again.
+ *
+ * With structural hashing enabled, a table that misses the identity cache is looked up by its contents: keys, scalar
+ * values and the identity of property objects, recursively. Tables built by the same code with the same (shared)
+ * property objects then share a single compiled style as well. Structural entries hold their compiled style (and
+ * thus their properties, whose addresses are part of the signature); unused entries are dropped as the map grows.
+ */
+class StyleCache {
+public:
+    explicit StyleCache(lua_State* L): mLua(L) {}
+
+    struct Compiled {
+        /**
+         * @brief Stylesheet of a table with selectors; nullptr if the table is a plain declaration list.
+         */
+        _<AStylesheet> stylesheet;
+
+        /**
+         * @brief Declarations of a table without selectors.
+         */
+        ass::PropertyListRecursive customStyle;
+    };
+
+    /**
+     * @brief Compiled style of the table, compiling it on cache miss.
+     * @throws AException if the table is not a valid style declaration.
+     */
+    _<const Compiled> get(const clg::ref& table);
+
+    /**
+     * @brief Drops the compiled style of the table, so the next get compiles it again.
+     */
+    void invalidate(const clg::ref& table);
+
+    void setStructuralHashing(bool structuralHashing) {
+        mStructuralHashing = structuralHashing;
+        if (!structuralHashing) {
+            mStructuralEntries.clear();
+        }
+    }
+
+    [[nodiscard]]
+    bool structuralHashing() const noexcept {
+        return mStructuralHashing;
+    }
+
+    _<const Compiled> compile(const clg::ref& table) const;
+
+    /**
+     * @return true if the value is nil or an empty table.
+     */
+    bool isEmpty(const clg::ref& table) const;
+
+    /**
+     * @brief Structural signature of the table at stack index n.
+     */
+    static std::string signature(lua_State* L, int n);
+
+private:
+    lua_State* mLua;
+    bool mStructuralHashing = false;
+    std::unordered_map<std::string, _<const Compiled>> mStructuralEntries;
+    std::size_t mSweepThreshold = 64;
+
+    _<const Compiled> getStructural(lua_State* L, const clg::ref& table);
+};
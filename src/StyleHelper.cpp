@@ -110,7 +110,7 @@ void StyleHelper::processTableWithoutSelector(const clg::table& t, const AString
 }
 
 bool StyleHelper::processDeclaration(const clg::table& table) {
-    const auto L = clg::state();
+    const auto L = mLua;
     for (const auto&[className, v] : table) {
         clg::stack_integrity_check stackIntegrityCheck(L);
         if (v.isNull()) {
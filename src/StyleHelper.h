@@ -16,6 +16,8 @@
 
 class StyleHelper {
 public:
+    explicit StyleHelper(lua_State* L): mLua(L) {}
+
     [[nodiscard]]
     bool processDeclaration(const clg::table& table);
 
@@ -35,6 +37,7 @@ private:
 
     ass::AAssSelector parseSelector(std::string_view str);
 
+    lua_State* mLua;
     Rules mRules;
 };
 
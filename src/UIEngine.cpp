@@ -56,25 +56,44 @@
 #include <AUI/Platform/AClipboard.h>
 #include <AUI/Platform/AWindow.h>
 #include <LuaExposedView.h>
+#include <AUI/Util/ARaiiHelper.h>
+#include "LuaChunkLoader.h"
+#include <uiengine/LuaVec.h>
+#include <uiengine/LuaCanvas.h>
+#include "StyleCache.h"
+#include "InvalidationBatch.h"
+#include "HotReload.h"
+#include <uiengine/LuaOverrideProfiler.h>
+#include <AUI/Thread/AThread.h>
+#include <AUI/Thread/AThreadPool.h>
+#include <atomic>
+#include <optional>
 
 static constexpr auto LOG_TAG = "UIEngine";
-unsigned performance::AUI_VIEW_RENDER = 0;
+std::atomic<unsigned> performance::AUI_VIEW_RENDER{0};
 
 class UI {};
 class Window {};
+class Profiler {};
 
 static _<AWindow> currentWindow() {
     return _cast<AWindow>(aui::ptr::shared_from_this(AWindow::current()));
 }
 
-UIEngine::UIEngine(AViewContainer& surface):
-        mSurface(surface)
+UIEngine::UIEngine(AViewContainer& surface, lua_State* lua):
+        mSurface(surface),
+        mLua(lua),
+        mGcPacer(lua),
+        mProfiler(lua),
+        mStyleCache(std::make_unique<StyleCache>(lua)),
+        mInvalidationBatch(std::make_unique<InvalidationBatch>()),
+        mHotReload(std::make_unique<HotReload>(*this))
 {
     using namespace declarative;
 
     ExposeHelper expose(*this);
 
-    clg::state_interface lua(clg::state());
+    clg::state_interface lua(mLua);
     lua.set_global_value("IS_32BIT", bool(sizeof(void *) == 4));
     lua.set_global_value("IS_64BIT", bool(sizeof(void *) == 8));
 
@@ -87,19 +106,110 @@ UIEngine::UIEngine(AViewContainer& surface):
     lua.set_global_value("AUI_PLATFORM_MACOS", bool(AUI_PLATFORM_MACOS));
     lua.set_global_value("AUI_PLATFORM_IOS", bool(AUI_PLATFORM_IOS));
 
-    lua.set_global_value("SIGNAL_REMOVE", clg::table{});
+    // created right in this engine's state: clg value types would be built in clg::state(), which may be another one
+    lua_newtable(mLua);
+    lua_setglobal(mLua, "SIGNAL_REMOVE");
+    mSignalRemove = lua.global_variable("SIGNAL_REMOVE");
+    LuaVec::registerConstructors(mLua);
+    LuaCanvas::registerClass(mLua);
     lua.register_enum<ATouchscreenKeyboardPolicy>("TouchscreenKeyboardPolicy");
 
     lua.register_class<UI>()
         .staticFunction("setSurface", [this](const _<AView>& wrapper) {
+            if (mHotReload->reloading()) {
+                mHotReload->reconcileSurface(wrapper);
+                return;
+            }
             ALayoutInflater::inflate(mSurface, wrapper);
         })
+        .staticFunction("setHotReload", [this](bool enabled, std::optional<int> pollIntervalMs) {
+            setHotReload(enabled, std::chrono::milliseconds(pollIntervalMs.value_or(250)));
+        })
         .staticFunction("stealSurface", [this]() {
             auto wrapper = _new<LuaExposedView<AViewContainer>>(*this);
             auto oldSurface = mSurface.getViews().first();
             mSurface.removeView(oldSurface);
             ALayoutInflater::inflate(wrapper, oldSurface);
             return wrapper;
+        })
+        .staticFunction("batch", [this](const clg::function& callback) {
+            // end() applies the invalidations and may throw itself, so it is not run by a destructor during unwinding
+            mInvalidationBatch->begin();
+            try {
+                callback();
+            } catch (...) {
+                mInvalidationBatch->end();
+                throw;
+            }
+            mInvalidationBatch->end();
+        })
+        .staticFunction("invalidateStyle", [this](const clg::ref& table) {
+            mStyleCache->invalidate(table);
+        })
+        .staticFunction("setStyleStructuralHashing", [this](bool structuralHashing) {
+            mStyleCache->setStructuralHashing(structuralHashing);
+        })
+        .staticFunction("setGcBudget", [this](int budgetMicroseconds, std::optional<bool> generational) {
+            if (budgetMicroseconds <= 0) {
+                mGcPacer.disable();
+                return;
+            }
+            mGcPacer.enable(generational.value_or(false) ? LuaGcPacer::Mode::GENERATIONAL : LuaGcPacer::Mode::INCREMENTAL,
+                            std::chrono::microseconds(budgetMicroseconds));
+        })
+        .staticFunction("gcStats", [this]() {
+            const auto L = mLua;
+            auto stats = mGcPacer.stats();
+            return clg::table{
+                {"maxPauseUs", clg::ref::from_cpp(L, stats.maxPause.count())},
+                {"p99PauseUs", clg::ref::from_cpp(L, stats.p99Pause.count())},
+                {"totalPerSecondUs", clg::ref::from_cpp(L, stats.totalPerSecond.count())},
+                {"steps", clg::ref::from_cpp(L, stats.steps)},
+                {"cycles", clg::ref::from_cpp(L, stats.cycles)},
+            };
+        })
+        .staticFunction("overrideProfile", [this]() {
+            const auto L = mLua;
+            AVector<clg::table> result;
+            for (const auto& entry : LuaOverrideProfiler::snapshot()) {
+                result << clg::table{
+                    {"class", clg::ref::from_cpp(L, entry.className)},
+                    {"method", clg::ref::from_cpp(L, entry.method)},
+                    {"calls", clg::ref::from_cpp(L, entry.calls)},
+                    {"totalUs", clg::ref::from_cpp(L, double(entry.totalNs) / 1000.0)},
+                    {"maxUs", clg::ref::from_cpp(L, double(entry.maxNs) / 1000.0)},
+                };
+            }
+            return result;
+        })
+        .staticFunction("overrideProfileJson", [] {
+            return LuaOverrideProfiler::toJson();
+        })
+        .staticFunction("resetOverrideProfile", [] {
+            LuaOverrideProfiler::reset();
+        })
+        .staticFunction("ruleInterningStats", [this]() {
+            const auto L = mLua;
+            const auto& stats = mRuleInterningStats;
+            auto total = stats.hits + stats.misses;
+            return clg::table{
+                {"hits", clg::ref::from_cpp(L, stats.hits)},
+                {"misses", clg::ref::from_cpp(L, stats.misses)},
+                {"hitRate", clg::ref::from_cpp(L, total == 0 ? 0.0 : double(stats.hits) / double(total))},
+            };
+        })
+        .staticFunction("minSizeMemoStats", [this]() {
+            const auto L = mLua;
+            const auto& stats = mMinSizeMemoStats;
+            auto total = stats.hits + stats.misses;
+            return clg::table{
+                {"hits", clg::ref::from_cpp(L, stats.hits)},
+                {"misses", clg::ref::from_cpp(L, stats.misses)},
+                {"hitRate", clg::ref::from_cpp(L, total == 0 ? 0.0 : double(stats.hits) / double(total))},
+            };
+        })
+        .staticFunction("resetMinSizeMemoStats", [this]() {
+            mMinSizeMemoStats = {};
         });
 
     lua.register_function<currentWindow>("currentWindow");
@@ -109,6 +219,26 @@ UIEngine::UIEngine(AViewContainer& surface):
         .staticFunction<AClipboard::copyToClipboard>("copyToClipboard")
         .staticFunction<AClipboard::pasteFromClipboard>("pasteFromClipboard");
 
+    lua.register_class<Profiler>()
+        .staticFunction("start", [this](std::optional<int> intervalMicroseconds) {
+            mProfiler.start(std::chrono::microseconds(intervalMicroseconds.value_or(1000)));
+        })
+        .staticFunction("stop", [this]() {
+            mProfiler.stop();
+        })
+        .staticFunction("reset", [this]() {
+            mProfiler.reset();
+        })
+        .staticFunction("sampleCount", [this]() {
+            return mProfiler.sampleCount();
+        })
+        .staticFunction("folded", [this]() {
+            return mProfiler.folded();
+        })
+        .staticFunction("write", [this](const std::string& path) {
+            return mProfiler.writeFolded(path);
+        });
+
     lua.register_class<Window>()
         .staticFunction("focusNextView", []() {
             AUI_NULLSAFE(currentWindow())->focusNextView();
@@ -177,7 +307,7 @@ UIEngine::UIEngine(AViewContainer& surface):
 
     expose.view<MyButton>("Button")
             .method<&MyButton::setText>("setText")
-            .ctor<std::string>();
+            .ctor<AString>();
 
     expose.view<MyProgressBar>("Progressbar")
             .method<&MyProgressBar::value>("value")
@@ -353,7 +483,17 @@ UIEngine::UIEngine(AViewContainer& surface):
     expose.view<MyForEachUI>("ForEachUI")
         .builder<&MyForEachUI::setModel>("setModel")
         .builder<&MyForEachUI::setFactory>("setFactory")
+        .builder<&MyForEachUI::setKey>("setKey")
         .method<&MyForEachUI::notify>("notify")
+        .method<&MyForEachUI::notifyInserted>("notifyInserted")
+        .method<&MyForEachUI::notifyRemoved>("notifyRemoved")
+        .method<&MyForEachUI::notifyChanged>("notifyChanged")
+        .method<&MyForEachUI::notifyMoved>("notifyMoved")
+        .builder<&MyForEachUI::setVirtualized>("setVirtualized")
+        .builder<&MyForEachUI::setBind>("setBind")
+        .builder<&MyForEachUI::setRowHeight>("setRowHeight")
+        .builder<&MyForEachUI::setEstimatedRowHeight>("setEstimatedRowHeight")
+        .builder<&MyForEachUI::setOverscan>("setOverscan")
         .ctor<>()
         ;
 
@@ -616,32 +756,136 @@ UIEngine::UIEngine(AViewContainer& surface):
         auto container = _new<LuaExposedView<AViewContainer>>(*this);
         {
             // for data holder initializating
-            clg::push_to_lua(clg::state(), container);
-            clg::pop_from_lua<decltype(container)>(clg::state());
+            clg::push_to_lua(mLua, container);
+            clg::pop_from_lua<decltype(container)>(mLua);
         }
         container->setLayout(std::make_unique<AAdvancedGridLayout>(columns, rows));
-        auto childrenTable = UIEngine::luaChildrenTable(container);
-        for (auto v : views) {
-            childrenTable[v] = true;
-        }
+        UIEngine::addChildren(container, views);
         container->addViews(std::move(views));
         return container;
     });
 
     StateHelper::initLua(lua);
+
+    // static bindings get "Class:function" names in profiles, as view methods do (see ViewExposer)
+    for (const char* className : { "UI", "Window", "Profiler" }) {
+        lua_getglobal(mLua, className);
+        LuaProfiler::nameBindings(mLua, className);
+        lua_pop(mLua, 1);
+    }
 }
 
+UIEngine::~UIEngine() = default;
+
 _<AView> UIEngine::loadForm(std::string_view file) {
-    /*
-    APath fullpath = APath("ui") / file;
-    if (fullpath.isRegularFileExists()) {
+    APath fullpath = mFormsRoot / AString(file);
+    lua_State* L = mLua;
+    clg::stack_integrity_check check(L);
+    try {
+        LuaChunkLoader::load(L, fullpath.toStdString(),
+                             mBytecodeCacheDir.empty() ? std::filesystem::path() : std::filesystem::path(mBytecodeCacheDir.toStdString()));
+    } catch (const AException& e) {
+        ALogger::err(LOG_TAG) << "Unable to load form " << fullpath << ": " << e;
+        return nullptr;
+    } catch (const std::exception& e) {
+        // e.g. std::filesystem::filesystem_error of the bytecode cache
+        ALogger::err(LOG_TAG) << "Unable to load form " << fullpath << ": " << e.what();
+        return nullptr;
+    }
+    auto view = runForm(L, fullpath);
+    if (mHotReload->enabled()) {
+        mHotReload->formLoaded(fullpath.toStdString(), view);
+    }
+    return view;
+}
+
+void UIEngine::setHotReload(bool enabled, std::chrono::milliseconds pollInterval) {
+    mHotReload->setPolling(enabled, pollInterval);
+}
+
+bool UIEngine::reloadForm(std::string_view file) {
+    return mHotReload->reload((mFormsRoot / AString(file)).toStdString());
+}
+
+_<AView> UIEngine::runForm(lua_State* L, const AString& name) {
+    if (lua_pcall(L, 0, 1, 0) != LUA_OK) {
+        ALogger::err(LOG_TAG) << "Unable to load form " << name << ": " << lua_tostring(L, -1);
+        lua_pop(L, 1);
+        return nullptr;
+    }
+    ARaiiHelper pop = [&] {
+        lua_pop(L, 1);
+    };
+    if (lua_isnil(L, -1)) {
+        return nullptr;
+    }
+    auto view = clg::get_from_lua_raw<_<AView>>(L, -1);
+    if (view.is_error()) {
+        ALogger::err(LOG_TAG) << "Form " << name << " returned a non-view value";
+        return nullptr;
+    }
+    return *view;
+}
+
+void UIEngine::loadFormAsync(std::string_view file, std::function<void(_<AView>)> onLoaded) {
+    APath fullpath = mFormsRoot / AString(file);
+    auto path = std::filesystem::path(fullpath.toStdString());
+    auto cacheDir = mBytecodeCacheDir.empty() ? std::filesystem::path() : std::filesystem::path(mBytecodeCacheDir.toStdString());
+    auto chunkName = "@" + path.generic_string();
+    compileAsync([path, cacheDir] { return LuaChunkLoader::compileFile(path, cacheDir); },
+                 std::move(chunkName), fullpath, std::move(onLoaded));
+}
+
+void UIEngine::runAsync(std::string source, std::string chunkName, std::function<void(_<AView>)> onLoaded) {
+    auto name = AString(chunkName);
+    auto compile = [source = std::move(source), chunkName] { return LuaChunkLoader::compile(source, chunkName); };
+    compileAsync(std::move(compile), std::move(chunkName), std::move(name), std::move(onLoaded));
+}
+
+void UIEngine::compileAsync(std::function<std::string()> compile, std::string chunkName, AString name,
+                            std::function<void(_<AView>)> onLoaded) {
+    std::weak_ptr<char> guard = mAsyncGuard;
+    AThreadPool::global().run([this, guard, compile = std::move(compile), chunkName = std::move(chunkName),
+                               name = std::move(name), onLoaded = std::move(onLoaded)] {
+        // worker thread: only the private state of LuaChunkLoader is touched here. Whatever it throws is reported on
+        // the main thread, so onLoaded is called in any case
+        std::string bytecode;
+        std::optional<AString> error;
         try {
-            mState.do_file(fullpath.toStdString());
+            bytecode = compile();
+        } catch (const AException& e) {
+            error = e.getMessage();
         } catch (const std::exception& e) {
-            ALogger::err(LOG_TAG) << "Unable to load form: " << e;
+            error = AString(e.what());
+        } catch (...) {
+            error = "unknown exception";
         }
-    }*/
-    return nullptr;
+
+        AThread::main()->enqueue([this, guard, bytecode = std::move(bytecode), error = std::move(error), chunkName,
+                                  name, onLoaded] {
+            if (guard.expired()) {
+                return;
+            }
+            _<AView> view;
+            if (error) {
+                ALogger::err(LOG_TAG) << "Unable to load form " << name << ": " << *error;
+            } else {
+                lua_State* L = mLua;
+                clg::stack_integrity_check check(L);
+                try {
+                    LuaChunkLoader::loadBytecode(L, bytecode, chunkName);
+                    view = runForm(L, name);
+                } catch (const AException& e) {
+                    ALogger::err(LOG_TAG) << "Unable to load form " << name << ": " << e;
+                } catch (const std::exception& e) {
+                    ALogger::err(LOG_TAG) << "Unable to load form " << name << ": " << e.what();
+                }
+            }
+            if (onLoaded) {
+                onLoaded(std::move(view));
+            }
+        });
+    });
 }
 
 const char* UIEngine::anyToString(const clg::ref& r) {
@@ -661,29 +905,35 @@ std::string UIEngine::clgDump(clg::ref any) {
     return any.debug_str();
 }
 
-clg::table_view UIEngine::luaChildrenTable(const _<AViewContainer>& cont) {
-    if (auto luaView = _cast<ILuaExposedView>(cont)) {
-        return luaView->luaDataHolder()
-                    .get_or_create("cpp_children", []() { return clg::table{}; })
-                    .as<clg::table_view>();
-    }
-
-    return clg::ref(nullptr);
-}
-
 void UIEngine::addChild(const _<AViewContainer>& cont, const _<AView>& view) {
     assert(view != nullptr);
-    AUI_NULLSAFE(luaChildrenTable(cont))[view] = true;
+    if (auto luaView = ILuaExposedView::fromView(cont.get())) {
+        luaView->anchorChildren({ &view, 1 });
+    }
 }
 
 void UIEngine::removeChild(const _<AViewContainer>& cont, const _<AView>& view) {
     assert(view != nullptr);
-    AUI_NULLSAFE(luaChildrenTable(cont))[view] = clg::ref(nullptr);
+    if (auto luaView = ILuaExposedView::fromView(cont.get())) {
+        luaView->releaseChildren({ &view, 1 });
+    }
+}
+
+void UIEngine::addChildren(const _<AViewContainer>& cont, const AVector<_<AView>>& views) {
+    if (auto luaView = ILuaExposedView::fromView(cont.get())) {
+        luaView->anchorChildren(views);
+    }
+}
+
+void UIEngine::removeChildren(const _<AViewContainer>& cont, const AVector<_<AView>>& views) {
+    if (auto luaView = ILuaExposedView::fromView(cont.get())) {
+        luaView->releaseChildren(views);
+    }
 }
 
 void UIEngine::removeAllChildren(const _<AViewContainer>& cont) {
-    if (auto luaView = _cast<ILuaExposedView>(cont)) {
-        luaView->luaDataHolder()["cpp_children"] = clg::ref(nullptr);
+    if (auto luaView = ILuaExposedView::fromView(cont.get())) {
+        luaView->releaseAllChildren();
     }
 }
 
@@ -8,134 +8,709 @@
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 //
 
-#include <range/v3/all.hpp>
-#include <AUI/View/AForEachUI.h>
-#include <AUI/Util/ALayoutInflater.h>
+#include <AUI/Common/AException.h>
 #include <AUI/Layout/AVerticalLayout.h>
 #include <AUI/Util/UIBuildingHelpers.h>
+#include <AUI/View/AScrollArea.h>
 #include <uiengine/Converters.h>
+#include <uiengine/UIEngine.h>
+#include <algorithm>
+#include <climits>
+#include <unordered_map>
 #include "MyForEachUI.h"
 
 using namespace declarative;
 using namespace ass;
 
-template<>
-struct std::hash<clg::ref> {
-    std::size_t operator()(const clg::ref& r) {
-        clg::stack_integrity_check c;
-        r.push_value_to_stack();
-        auto value = lua_topointer(clg::state(), -1);
-        std::uintptr_t hash = 0;
-        hash = reinterpret_cast<std::uintptr_t>(value);
-        if (!hash) {
-            hash = lua_tointeger(clg::state(), -1);
-        }
-        lua_pop(clg::state(), 1);
-#if AUI_DEBUG
-        ALogger::info("Test") << "Value: " << r.debug_str() << " hash: " << hash;
-        AUI_ASSERT(hash != 0);
-#endif
-        return hash;
+namespace {
+    /**
+     * @brief Upper bound of the recycled views pool, relative to the number of active rows.
+     */
+    constexpr std::size_t RECYCLED_ROWS_FACTOR = 2;
+    constexpr std::size_t MIN_RECYCLED_ROWS = 16;
+
+    /**
+     * @brief Bound of measure passes per update: measured heights move row offsets and thus the visible range.
+     */
+    constexpr int MAX_MEASURE_PASSES = 4;
+
+    /**
+     * @return address of the table or userdata on the top of the stack; nullptr for other values.
+     */
+    const void* identityOf(lua_State* L) noexcept {
+        switch (lua_type(L, -1)) {
+            case LUA_TTABLE:
+            case LUA_TUSERDATA:
+            case LUA_TLIGHTUSERDATA:
+            case LUA_TFUNCTION:
+            case LUA_TTHREAD:
+                return lua_topointer(L, -1);
+            default:
+                return nullptr;
+        }
     }
-};
+}
 
-struct MyForEachUI::ListAdapter {
+/**
+ * @brief Rows container of virtualized mode: rows are positioned by MyForEachUI; the container reports the height of
+ * all rows, including ones without views.
+ */
+class MyForEachUI::VirtualRows: public AViewContainer {
 public:
-    struct iterator {
-    public:
-        using iterator_category = std::input_iterator_tag;
-        using difference_type = std::ptrdiff_t;
-        using value_type = clg::ref;
+    int contentHeight = 0;
 
-        iterator() = default;
-        iterator(MyForEachUI* parent, size_t index) : parent(parent), index(index) {}
+    int getContentMinimumHeight() override {
+        return contentHeight;
+    }
+};
 
-        auto operator<=>(const iterator&) const = default;
+MyForEachUI::MyForEachUI()
+  : mEstimatedRowHeight((32_dp).getValuePx()),
+    mOverscan((200_dp).getValuePx()) {
+    resetContents();
+}
 
-        auto operator*() const {
-            return parent->model()[index].as<clg::ref>();
-        }
+void MyForEachUI::resetContents() {
+    if (mVirtualized) {
+        mRowsContainer = _new<VirtualRows>();
+        mRowsContainer->setCustomStyle({ Expanding() });
+        setContents(mRowsContainer);
+        return;
+    }
+    mRowsContainer = _new<AViewContainer>();
+    mRowsContainer->setLayout(std::make_unique<AVerticalLayout>());
+    mRowsContainer->setCustomStyle({ Expanding() });
+    setContents(Centered { mRowsContainer });
+}
 
-        auto& operator++() {
-            index += 1;
-            return *this;
-        }
+std::size_t MyForEachUI::rowCount() const noexcept {
+    return mVirtualized ? mRowHeights.size() : mRows.size();
+}
+
+void MyForEachUI::setModel(clg::ref model) {
+    asLuaSelf(this)->luaDataHolder()["cpp_model"] = std::move(model);
+    notify();
+}
+
+void MyForEachUI::setFactory(clg::function factory) {
+    asLuaSelf(this)->luaDataHolder()["cpp_factory"] = std::move(factory);
+    rebuild();
+}
+
+void MyForEachUI::setKey(clg::function key) {
+    asLuaSelf(this)->luaDataHolder()["cpp_key"] = std::move(key);
+    auto ctx = context();
+    if (!ctx) {
+        return;
+    }
+    for (std::size_t i = 0; i < mRows.size(); ++i) {
+        assignKey(*ctx, mRows[i], ctx->model[i + 1].as<clg::ref>());
+    }
+}
+
+void MyForEachUI::setBind(clg::ref bind) {
+    auto holder = asLuaSelf(this)->luaDataHolder();
+    holder["cpp_bind"] = std::move(bind);
+    mHasBind = holder["cpp_bind"].is<clg::function>().has_value();
+    if (!mHasBind) {
+        mRecycledRows.clear();
+    }
+}
+
+void MyForEachUI::setVirtualized(bool virtualized) {
+    if (mVirtualized == virtualized) {
+        return;
+    }
+    mVirtualized = virtualized;
+    mRows.clear();
+    mActiveRows.clear();
+    mRecycledRows.clear();
+    mRowHeights.clear();
+    invalidateRowOffsets(0);
+    resetContents();
+    notify();
+}
+
+void MyForEachUI::setRowHeight(AMetric height) {
+    mFixedRowHeight = height.getValuePx();
+    invalidateRowOffsets(0);
+    updateVirtualRows();
+}
+
+void MyForEachUI::setEstimatedRowHeight(AMetric height) {
+    mFixedRowHeight.reset();
+    mEstimatedRowHeight = height.getValuePx();
+    invalidateRowOffsets(0);
+    updateVirtualRows();
+}
+
+void MyForEachUI::setOverscan(AMetric overscan) {
+    mOverscan = std::max(int(overscan.getValuePx()), 0);
+    updateVirtualRows();
+}
+
+clg::table_view MyForEachUI::model() {
+    return asLuaSelf(this)->luaDataHolder()["cpp_model"].as<clg::table_view>();
+}
+
+std::optional<MyForEachUI::Context> MyForEachUI::context() {
+    auto self = asLuaSelf(this)->luaDataHolder();
 
-        auto& operator--() {
-            index -= 1;
-            index = glm::max(size_t(1), index);
-            return *this;
+    if (!self["cpp_model"].is<clg::table>()) {
+        return std::nullopt;
+    }
+    auto factory = self["cpp_factory"].is<clg::function>();
+    if (!factory) {
+        return std::nullopt;
+    }
+    return Context {
+        .model = self["cpp_model"].as<clg::table_view>(),
+        .factory = std::move(*factory),
+        .key = self["cpp_key"].is<clg::function>(),
+        .bind = self["cpp_bind"].is<clg::function>(),
+    };
+}
+
+void MyForEachUI::assignKey(Context& context, Row& row, const clg::ref& item) {
+    auto L = ILuaExposedView::fromView(this)->uiEngine().luaState();
+    clg::stack_integrity_check check(L);
+    item.push_value_to_stack(L);
+    row.identity = identityOf(L);
+    row.item = row.identity ? item : clg::ref();
+    if (context.key && !mVirtualized) {
+        lua_pop(L, 1);
+        row.keyRef = context.key->call<clg::ref>(item);
+        row.keyRef.push_value_to_stack(L);
+    } else {
+        row.keyRef = clg::ref();
+    }
+    switch (lua_type(L, -1)) {
+        case LUA_TNIL:
+            row.key = std::monostate{};
+            break;
+        case LUA_TBOOLEAN:
+            row.key = bool(lua_toboolean(L, -1));
+            break;
+        case LUA_TNUMBER:
+            if (lua_isinteger(L, -1)) {
+                row.key = lua_tointeger(L, -1);
+            } else {
+                row.key = lua_tonumber(L, -1);
+            }
+            break;
+        case LUA_TSTRING: {
+            std::size_t length = 0;
+            const char* s = lua_tolstring(L, -1, &length);
+            row.key = std::string(s, length);
+            break;
         }
+        default:
+            row.key = lua_topointer(L, -1);
+            break;
+    }
+    if (!std::holds_alternative<const void*>(row.key)) {
+        row.keyRef = clg::ref();
+    }
+    lua_pop(L, 1);
+}
 
-        auto operator++(int) {
-            auto copy = *this;
-            operator++();
-            return copy;
+MyForEachUI::Row MyForEachUI::makeRow(Context& context, std::size_t index) {
+    auto item = context.model[index].as<clg::ref>();
+    Row row;
+    assignKey(context, row, item);
+    row.view = context.factory.call<_<AView>>(item);
+    if (!row.view) {
+        // keeps rows and views aligned
+        row.view = _new<AView>();
+    }
+    return row;
+}
+
+void MyForEachUI::rebuild() {
+    mRowsContainer->removeAllViews();
+    mRows.clear();
+    mActiveRows.clear();
+    mRecycledRows.clear();
+    // views of another factory may have other heights
+    mRowHeights.clear();
+    invalidateRowOffsets(0);
+    notify();
+}
+
+void MyForEachUI::notify() {
+    auto ctx = context();
+    if (!ctx) {
+        return;
+    }
+    if (mVirtualized) {
+        // rows are positional here: only those showing another item than before are rebound and remeasured; measured
+        // heights of the other rows are kept, so the content above the visible area does not move
+        auto count = ctx->model.raw_len();
+        while (!mActiveRows.empty() && mFirstActive + mActiveRows.size() > count) {
+            recycleRow(mActiveRows.back());
+            mActiveRows.pop_back();
+        }
+        if (count != mRowHeights.size()) {
+            invalidateRowOffsets(std::min(count, mRowHeights.size()));
+            mRowHeights.resize(count, -1);
+        }
+        for (std::size_t i = 0; i < mActiveRows.size(); ++i) {
+            auto& row = mActiveRows[i];
+            if (!row.view) {
+                continue;
+            }
+            Row current;
+            auto index = mFirstActive + i;
+            assignKey(*ctx, current, ctx->model[index + 1].as<clg::ref>());
+            if (current.key != row.key) {
+                rebind(*ctx, row, index);
+                mRowHeights[index] = -1;
+                invalidateRowOffsets(index);
+            }
+        }
+        updateVirtualRows();
+        return;
+    }
+    // rows are matched by item identity first, which needs no key function call, then by key
+    std::unordered_map<const void*, std::size_t> oldIdentities;
+    std::unordered_multimap<RowKey, std::size_t> oldRows;
+    oldIdentities.reserve(mRows.size());
+    oldRows.reserve(mRows.size());
+    for (std::size_t i = 0; i < mRows.size(); ++i) {
+        if (mRows[i].identity) {
+            oldIdentities.emplace(mRows[i].identity, i);
         }
+        oldRows.emplace(mRows[i].key, i);
+    }
+    std::vector<bool> taken(mRows.size(), false);
+    auto take = [&](std::size_t i) -> std::optional<Row> {
+        if (taken[i]) {
+            return std::nullopt;
+        }
+        taken[i] = true;
+        return std::move(mRows[i]);
+    };
 
-        auto operator--(int) {
-            auto copy = *this;
-            operator++();
-            return copy;
+    auto L = ILuaExposedView::fromView(this)->uiEngine().luaState();
+    auto count = ctx->model.raw_len();
+    std::vector<Row> rows;
+    rows.reserve(count);
+    for (std::size_t i = 1; i <= count; ++i) {
+        auto item = ctx->model[i].as<clg::ref>();
+        const void* identity;
+        {
+            clg::stack_integrity_check check(L);
+            item.push_value_to_stack(L);
+            identity = identityOf(L);
+            lua_pop(L, 1);
+        }
+        if (identity) {
+            if (auto it = oldIdentities.find(identity); it != oldIdentities.end()) {
+                if (auto row = take(it->second)) {
+                    rows.push_back(std::move(*row));
+                    continue;
+                }
+            }
         }
 
-    private:
-        MyForEachUI* parent = nullptr;
-        size_t index = 0;
-    };
+        Row row;
+        assignKey(*ctx, row, item);
+        std::optional<Row> kept;
+        for (auto [it, end] = oldRows.equal_range(row.key); it != end && !kept; ++it) {
+            kept = take(it->second);
+        }
+        if (kept) {
+            row.view = std::move(kept->view);
+        } else {
+            row.view = ctx->factory.call<_<AView>>(item);
+            if (!row.view) {
+                row.view = _new<AView>();
+            }
+        }
+        rows.push_back(std::move(row));
+    }
+    applyRows(std::move(rows));
+}
 
-    ListAdapter(MyForEachUI* parent): parent(parent) {
+void MyForEachUI::applyRows(std::vector<Row> rows) {
+    const auto common = std::min(mRows.size(), rows.size());
+    std::size_t prefix = 0;
+    while (prefix < common && mRows[prefix].view == rows[prefix].view) {
+        ++prefix;
+    }
+    std::size_t suffix = 0;
+    while (suffix < common - prefix && mRows[mRows.size() - 1 - suffix].view == rows[rows.size() - 1 - suffix].view) {
+        ++suffix;
+    }
 
+    for (auto i = mRows.size() - suffix; i-- > prefix;) {
+        mRowsContainer->removeView(i);
     }
+    for (auto i = prefix; i < rows.size() - suffix; ++i) {
+        mRowsContainer->addView(i, rows[i].view);
+    }
+    mRows = std::move(rows);
+    mRowsContainer->markMinContentSizeInvalid();
+}
 
-    iterator begin() const {
-        aui::react::DependencyObserverScope::addDependency(parent->notified);
-        return {parent, 1};
+void MyForEachUI::checkModelSize(Context& context, std::size_t expected, const char* method) {
+    if (auto actual = context.model.raw_len(); actual != expected) {
+        throw AException("ForEachUI:{}: model has {} items, {} expected"_format(method, actual, expected));
     }
+}
 
-    iterator end() const {
-        return {parent, parent->model().raw_len() + 1 };
+void MyForEachUI::notifyInserted(int index, std::optional<int> count) {
+    auto ctx = context();
+    if (!ctx) {
+        return;
+    }
+    auto n = std::size_t(count.value_or(1));
+    if (index < 1 || std::size_t(index) > rowCount() + 1) {
+        throw AException("ForEachUI:notifyInserted: index {} is out of bounds"_format(index));
+    }
+    checkModelSize(*ctx, rowCount() + n, "notifyInserted");
+    if (mVirtualized) {
+        // active rows after the insertion point shift; the inserted ones are made by updateVirtualRows if visible
+        auto at = std::size_t(index - 1);
+        if (!mActiveRows.empty()) {
+            if (at <= mFirstActive) {
+                mFirstActive += n;
+            } else if (at < mFirstActive + mActiveRows.size()) {
+                mActiveRows.insert(mActiveRows.begin() + (at - mFirstActive), n, Row{});
+            }
+        }
+        mRowHeights.insert(mRowHeights.begin() + at, n, -1);
+        invalidateRowOffsets(at);
+        updateVirtualRows();
+        return;
     }
 
-private:
-    MyForEachUI* parent;
-};
+    std::vector<Row> inserted;
+    inserted.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        inserted.push_back(makeRow(*ctx, index + i));
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        mRowsContainer->addView(index - 1 + i, inserted[i].view);
+    }
+    mRows.insert(mRows.begin() + (index - 1), std::make_move_iterator(inserted.begin()), std::make_move_iterator(inserted.end()));
+    mRowsContainer->markMinContentSizeInvalid();
+}
 
+void MyForEachUI::notifyRemoved(int index, std::optional<int> count) {
+    auto ctx = context();
+    if (!ctx) {
+        return;
+    }
+    auto n = std::size_t(count.value_or(1));
+    if (index < 1 || std::size_t(index) - 1 + n > rowCount()) {
+        throw AException("ForEachUI:notifyRemoved: range [{}, {}) is out of bounds"_format(index, index + n));
+    }
+    checkModelSize(*ctx, rowCount() - n, "notifyRemoved");
+    if (mVirtualized) {
+        auto at = std::size_t(index - 1);
+        auto end = at + n;
+        auto from = std::max(at, mFirstActive);
+        auto to = std::min(end, mFirstActive + mActiveRows.size());
+        if (from < to) {
+            for (auto i = from; i < to; ++i) {
+                recycleRow(mActiveRows[i - mFirstActive]);
+            }
+            mActiveRows.erase(mActiveRows.begin() + (from - mFirstActive), mActiveRows.begin() + (to - mFirstActive));
+        }
+        if (at < mFirstActive) {
+            mFirstActive -= std::min(end, mFirstActive) - at;
+        }
+        mRowHeights.erase(mRowHeights.begin() + at, mRowHeights.begin() + end);
+        invalidateRowOffsets(at);
+        updateVirtualRows();
+        return;
+    }
 
-MyForEachUI::MyForEachUI() {
-    static_assert(ranges::input_iterator<MyForEachUI::ListAdapter::iterator>);
-    static_assert(ranges::range<MyForEachUI::ListAdapter>);
+    for (auto i = std::size_t(index) - 1 + n; i-- > std::size_t(index) - 1;) {
+        mRowsContainer->removeView(i);
+    }
+    mRows.erase(mRows.begin() + (index - 1), mRows.begin() + (index - 1 + n));
+    mRowsContainer->markMinContentSizeInvalid();
 }
 
-void MyForEachUI::setModel(clg::ref model) {
-    asLuaSelf(this)->luaDataHolder()["cpp_model"] = std::move(model);
-    tryFullUpdate();
+void MyForEachUI::notifyChanged(int index) {
+    auto ctx = context();
+    if (!ctx) {
+        return;
+    }
+    if (index < 1 || std::size_t(index) > rowCount()) {
+        throw AException("ForEachUI:notifyChanged: index {} is out of bounds"_format(index));
+    }
+    checkModelSize(*ctx, rowCount(), "notifyChanged");
+    if (mVirtualized) {
+        auto i = std::size_t(index - 1);
+        if (i >= mFirstActive && i < mFirstActive + mActiveRows.size() && mActiveRows[i - mFirstActive].view) {
+            rebind(*ctx, mActiveRows[i - mFirstActive], i);
+        }
+        mRowHeights[i] = -1;
+        invalidateRowOffsets(i);
+        updateVirtualRows();
+        return;
+    }
+
+    auto& row = mRows[index - 1];
+    row = makeRow(*ctx, index);
+    mRowsContainer->removeView(index - 1);
+    mRowsContainer->addView(index - 1, row.view);
+    mRowsContainer->markMinContentSizeInvalid();
 }
 
-void MyForEachUI::setFactory(clg::function factory) {
-    asLuaSelf(this)->luaDataHolder()["cpp_factory"] = std::move(factory);
-    tryFullUpdate();
+void MyForEachUI::notifyMoved(int from, int to) {
+    if (from < 1 || std::size_t(from) > rowCount() || to < 1 || std::size_t(to) > rowCount()) {
+        throw AException("ForEachUI:notifyMoved: {} -> {} is out of bounds"_format(from, to));
+    }
+    if (from == to) {
+        return;
+    }
+    if (mVirtualized) {
+        auto f = std::size_t(from - 1);
+        auto t = std::size_t(to - 1);
+        std::optional<Row> moved;
+        if (f >= mFirstActive && f < mFirstActive + mActiveRows.size()) {
+            moved = std::move(mActiveRows[f - mFirstActive]);
+            mActiveRows.erase(mActiveRows.begin() + (f - mFirstActive));
+        } else if (f < mFirstActive) {
+            --mFirstActive;
+        }
+        if (!mActiveRows.empty() && t >= mFirstActive && t <= mFirstActive + mActiveRows.size()) {
+            mActiveRows.insert(mActiveRows.begin() + (t - mFirstActive), moved ? std::move(*moved) : Row{});
+        } else {
+            if (!mActiveRows.empty() && t < mFirstActive) {
+                ++mFirstActive;
+            }
+            if (moved) {
+                recycleRow(*moved);
+            }
+        }
+        auto height = mRowHeights[f];
+        mRowHeights.erase(mRowHeights.begin() + f);
+        mRowHeights.insert(mRowHeights.begin() + t, height);
+        invalidateRowOffsets(std::min(f, t));
+        updateVirtualRows();
+        return;
+    }
+    auto row = std::move(mRows[from - 1]);
+    mRows.erase(mRows.begin() + (from - 1));
+    mRowsContainer->removeView(from - 1);
+    mRowsContainer->addView(to - 1, row.view);
+    mRows.insert(mRows.begin() + (to - 1), std::move(row));
+    mRowsContainer->markMinContentSizeInvalid();
 }
 
-void MyForEachUI::tryFullUpdate() {
-    auto self = asLuaSelf(this)->luaDataHolder();
+void MyForEachUI::setSize(glm::ivec2 size) {
+    AViewContainerBase::setSize(size);
+    if (mVirtualized) {
+        watchScrollArea();
+        updateVirtualRows();
+    }
+}
 
-    if (!self["cpp_model"].is<clg::table>()) {
+void MyForEachUI::watchScrollArea() {
+    _<AScrollbar> scrollbar;
+    for (auto parent = getParent(); parent != nullptr; parent = parent->getParent()) {
+        if (auto area = dynamic_cast<AScrollArea*>(parent)) {
+            scrollbar = area->verticalScrollbar();
+            break;
+        }
+    }
+    auto previous = mScrollbar.lock();
+    if (previous == scrollbar) {
         return;
     }
-    if (!self["cpp_factory"].is<clg::function>()) {
+    // the view was reparented or the scroll area was replaced: the old one must not update this view anymore
+    if (previous) {
+        previous->scrolled.clearAllOutgoingConnectionsWith(this);
+    }
+    mScrollbar = scrollbar;
+    if (scrollbar) {
+        connect(scrollbar->scrolled, [this] {
+            updateVirtualRows();
+        });
+    }
+}
+
+int MyForEachUI::rowHeight(std::size_t index) const noexcept {
+    if (mFixedRowHeight) {
+        return *mFixedRowHeight;
+    }
+    auto height = mRowHeights[index];
+    return height >= 0 ? height : mEstimatedRowHeight;
+}
+
+void MyForEachUI::invalidateRowOffsets(std::size_t from) noexcept {
+    mRowOffsetsDirtyFrom = std::min(mRowOffsetsDirtyFrom, from);
+}
+
+void MyForEachUI::ensureRowOffsets() {
+    if (mRowOffsetsDirtyFrom == ROW_OFFSETS_VALID) {
         return;
     }
-    auto list = ListAdapter(this);
-    setContents(Centered { AUI_DECLARATIVE_FOR(i, list, AVerticalLayout) {
-        return self["cpp_factory"].as<clg::function>().call<_<AView>>(i);
-    } AUI_OVERRIDE_STYLE { Expanding() } });
+    // offsets up to and including the first invalidated row are still valid
+    auto from = std::min(mRowOffsetsDirtyFrom, mRowHeights.size());
+    mRowOffsetsDirtyFrom = ROW_OFFSETS_VALID;
+    mRowOffsets.resize(mRowHeights.size() + 1);
+    mRowOffsets[0] = 0;
+    for (std::size_t i = from; i < mRowHeights.size(); ++i) {
+        mRowOffsets[i + 1] = mRowOffsets[i] + rowHeight(i);
+    }
+
+    auto& rows = static_cast<VirtualRows&>(*mRowsContainer);
+    if (rows.contentHeight != mRowOffsets.back()) {
+        rows.contentHeight = mRowOffsets.back();
+        rows.markMinContentSizeInvalid();
+    }
 }
 
-clg::table_view MyForEachUI::model() {
-    return asLuaSelf(this)->luaDataHolder()["cpp_model"].as<clg::table_view>();
+std::size_t MyForEachUI::rowAt(int y) const noexcept {
+    // last row starting at or above y
+    auto it = std::upper_bound(mRowOffsets.begin(), mRowOffsets.end() - 1, y);
+    if (it == mRowOffsets.begin()) {
+        return 0;
+    }
+    return std::size_t(it - mRowOffsets.begin()) - 1;
 }
 
-void MyForEachUI::notify() {
-    emit notified();
+std::pair<int, int> MyForEachUI::visibleRange() const {
+    int top = INT_MIN;
+    int bottom = INT_MAX;
+    for (AView* view = mRowsContainer->getParent(); view != nullptr; view = view->getParent()) {
+        auto y = view->getPositionInWindow().y;
+        top = std::max(top, y);
+        bottom = std::min(bottom, y + view->getSize().y);
+    }
+    auto origin = mRowsContainer->getPositionInWindow().y;
+    return { top - origin, bottom - origin };
+}
+
+void MyForEachUI::recycle(_<AView> view) {
+    mRowsContainer->removeView(view);
+    if (mHasBind && mRecycledRows.size() < std::max(MIN_RECYCLED_ROWS, mActiveRows.size() * RECYCLED_ROWS_FACTOR)) {
+        mRecycledRows.push_back(std::move(view));
+    }
+}
+
+void MyForEachUI::recycleRow(Row& row) {
+    if (row.view) {
+        recycle(std::move(row.view));
+    }
+}
+
+void MyForEachUI::releaseVirtualRows() {
+    for (auto& row : mActiveRows) {
+        recycleRow(row);
+    }
+    mActiveRows.clear();
+    mFirstActive = 0;
+}
+
+MyForEachUI::Row MyForEachUI::acquire(Context& context, std::size_t index) {
+    auto item = context.model[index + 1].as<clg::ref>();
+    Row row;
+    assignKey(context, row, item);
+    if (context.bind && !mRecycledRows.empty()) {
+        row.view = std::move(mRecycledRows.back());
+        mRecycledRows.pop_back();
+        (*context.bind)(row.view, item);
+    } else {
+        row.view = context.factory.call<_<AView>>(item);
+        if (!row.view) {
+            row.view = _new<AView>();
+        }
+    }
+    mRowsContainer->addViewCustomLayout(row.view);
+    return row;
+}
+
+void MyForEachUI::rebind(Context& context, Row& row, std::size_t index) {
+    // with a bind function, the view just released is taken back from the pool
+    recycleRow(row);
+    row = acquire(context, index);
+}
+
+void MyForEachUI::updateVirtualRows() {
+    if (!mVirtualized) {
+        return;
+    }
+    auto ctx = context();
+    if (!ctx) {
+        return;
+    }
+    if (auto count = ctx->model.raw_len(); count != mRowHeights.size()) {
+        // the model was changed without notifying
+        releaseVirtualRows();
+        mRowHeights.assign(count, -1);
+        invalidateRowOffsets(0);
+    }
+
+    for (int pass = 0; pass < MAX_MEASURE_PASSES; ++pass) {
+        ensureRowOffsets();
+        if (mRowHeights.empty()) {
+            return;
+        }
+
+        auto [top, bottom] = visibleRange();
+        auto first = rowAt(top - mOverscan);
+        auto last = std::min(rowAt(bottom + mOverscan) + 1, mRowHeights.size());
+        if (bottom + mOverscan < 0 || top - mOverscan >= mRowOffsets.back()) {
+            // not visible at all
+            first = last = 0;
+        }
+
+        while (!mActiveRows.empty() && mFirstActive < first) {
+            recycleRow(mActiveRows.front());
+            mActiveRows.pop_front();
+            ++mFirstActive;
+        }
+        while (!mActiveRows.empty() && mFirstActive + mActiveRows.size() > last) {
+            recycleRow(mActiveRows.back());
+            mActiveRows.pop_back();
+        }
+        if (mActiveRows.empty()) {
+            mFirstActive = first;
+        }
+        while (mFirstActive > first) {
+            --mFirstActive;
+            mActiveRows.emplace_front();
+        }
+        while (mFirstActive + mActiveRows.size() < last) {
+            mActiveRows.emplace_back();
+        }
+        for (std::size_t i = 0; i < mActiveRows.size(); ++i) {
+            if (!mActiveRows[i].view) {
+                mActiveRows[i] = acquire(*ctx, mFirstActive + i);
+            }
+        }
+
+        if (mFixedRowHeight) {
+            break;
+        }
+        bool changed = false;
+        for (std::size_t i = 0; i < mActiveRows.size(); ++i) {
+            auto height = mActiveRows[i].view->getMinimumHeight();
+            auto& known = mRowHeights[mFirstActive + i];
+            if (known != height) {
+                known = height;
+                invalidateRowOffsets(mFirstActive + i);
+                changed = true;
+            }
+        }
+        if (!changed) {
+            break;
+        }
+        // offsets moved; the visible range is revisited
+    }
+    ensureRowOffsets();
+
+    auto width = mRowsContainer->getWidth();
+    for (std::size_t i = 0; i < mActiveRows.size(); ++i) {
+        auto index = mFirstActive + i;
+        mActiveRows[i].view->setGeometry(0, mRowOffsets[index], width, rowHeight(index));
+    }
+    redraw();
 }
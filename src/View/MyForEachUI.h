@@ -10,9 +10,30 @@
 
 #pragma once
 
+#include <AUI/View/AViewContainer.h>
 #include <AUI/View/AViewContainerBase.h>
+#include <AUI/View/AScrollbar.h>
+#include <AUI/Util/AMetric.h>
 #include "LuaSelfAccessor.h"
+#include <deque>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
 
+/**
+ * @brief Lua list view: a view per element of the model table, made by the factory function.
+ * @details
+ * Rows are tracked by item keys, which are computed once per row and cached. notify() reconciles rows with the
+ * model by keys, reusing views of kept items; notifyInserted/Removed/Changed/Moved touch only the affected rows
+ * without walking the model.
+ *
+ * In virtualized mode (see setVirtualized) only rows intersecting the visible area have views.
+ *
+ * Indices of the Lua API are 1-based, as the model is.
+ */
 class MyForEachUI: public AViewContainerBase, private LuaSelfAccessor {
 public:
     MyForEachUI();
@@ -21,13 +42,181 @@ public:
     void setModel(clg::ref model);
     void setFactory(clg::function factory);
 
+    /**
+     * @brief Function item -> key identifying the item across model updates.
+     * @details
+     * By default, items are identified by themselves: tables and userdata by reference, scalars by value. Rows of
+     * virtualized mode are positional and always identified by their items; the key function is not used there.
+     *
+     * The key of a table or userdata item is computed once: notify() reuses the row of an item it has already seen
+     * without calling the key function again.
+     */
+    void setKey(clg::function key);
+
     clg::table_view model();
 
+    /**
+     * @brief Reconciles rows with the model by item keys. Rows of items whose keys are still present are kept as is.
+     * @details
+     * In virtualized mode, only visible rows showing another item than before are rebound; a table item changed in
+     * place is not detected (use notifyChanged).
+     */
     void notify();
 
+    /**
+     * @brief count items were inserted into the model starting at index.
+     */
+    void notifyInserted(int index, std::optional<int> count);
+
+    /**
+     * @brief count items starting at index were removed from the model.
+     */
+    void notifyRemoved(int index, std::optional<int> count);
+
+    /**
+     * @brief The item at index was changed or replaced; its row is recreated.
+     */
+    void notifyChanged(int index);
+
+    /**
+     * @brief The item at from was moved to to (as table.insert(model, to, table.remove(model, from)) does).
+     */
+    void notifyMoved(int from, int to);
+
+    /**
+     * @brief Virtualized mode: views are made only for rows intersecting the visible area of the enclosing scroll
+     * area, extended by the overscan margin.
+     * @details
+     * Rows are updated on layout, on scroll of the enclosing scroll area and on notifications, never while rendering.
+     * Rows scrolled out are detached; with a bind function set (see setBind) they are recycled for other items instead
+     * of calling the factory. Notifications keep the views and the measured heights of the rows they do not affect.
+     * Row offsets come from the fixed row height (setRowHeight) or, if it is not set, from the measured minimum heights
+     * of rows that have been shown, using the estimated height (setEstimatedRowHeight) for the rest.
+     */
+    void setVirtualized(bool virtualized);
+
+    /**
+     * @brief Function (view, item) retargeting a recycled row view made by the factory to another item; nil removes it.
+     */
+    void setBind(clg::ref bind);
+
+    void setRowHeight(AMetric height);
+    void setEstimatedRowHeight(AMetric height);
+    void setOverscan(AMetric overscan);
+
+    void setSize(glm::ivec2 size) override;
+
 private:
-    void tryFullUpdate();
-    struct ListAdapter;
+    using RowKey = std::variant<std::monostate, bool, lua_Integer, lua_Number, std::string, const void*>;
+
+    struct Row {
+        RowKey key;
+        _<AView> view;
+
+        /**
+         * @brief Address of a table or userdata item; nullptr for scalars.
+         */
+        const void* identity = nullptr;
+
+        /**
+         * @brief Table or userdata item, held while the row exists so its address (identity and default key) is not
+         * reused by another object.
+         */
+        clg::ref item;
+
+        /**
+         * @brief Key returned by the key function if it is a table or userdata; held for the same reason.
+         */
+        clg::ref keyRef;
+    };
+
+    struct Context {
+        clg::table_view model;
+        clg::function factory;
+        std::optional<clg::function> key;
+        std::optional<clg::function> bind;
+    };
+
+    class VirtualRows;
+
+    _<AViewContainer> mRowsContainer;
+    std::vector<Row> mRows;
+
+    bool mVirtualized = false;
+    bool mHasBind = false;
+    std::optional<int> mFixedRowHeight;
+    int mEstimatedRowHeight;
+    int mOverscan;
+
+    /**
+     * @brief Measured row heights in virtualized mode; -1 if the row was not measured yet.
+     */
+    std::vector<int> mRowHeights;
+
+    /**
+     * @brief Prefix sums of row heights, mRowHeights.size() + 1 items.
+     */
+    std::vector<int> mRowOffsets;
+
+    static constexpr std::size_t ROW_OFFSETS_VALID = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * @brief First row whose height changed since mRowOffsets were computed; ROW_OFFSETS_VALID if none.
+     */
+    std::size_t mRowOffsetsDirtyFrom = 0;
+
+    /**
+     * @brief Rows [mFirstActive, mFirstActive + mActiveRows.size()) in virtualized mode. A row without a view is
+     * made by the next updateVirtualRows.
+     */
+    std::deque<Row> mActiveRows;
+    std::size_t mFirstActive = 0;
+    std::vector<_<AView>> mRecycledRows;
+
+    /**
+     * @brief Vertical scrollbar of the enclosing scroll area whose scrolled signal is connected; empty if the view is
+     * not in a scroll area.
+     */
+    std::weak_ptr<AScrollbar> mScrollbar;
+
+    std::optional<Context> context();
+    /**
+     * @brief Computes the key of the row's item and anchors the item and the key if they are referenced by address.
+     */
+    void assignKey(Context& context, Row& row, const clg::ref& item);
+    Row makeRow(Context& context, std::size_t index);
+
+    /**
+     * @brief Replaces the rows, touching only the range of views that differ from the current ones.
+     */
+    void applyRows(std::vector<Row> rows);
+    void rebuild();
+    void checkModelSize(Context& context, std::size_t expected, const char* method);
+    std::size_t rowCount() const noexcept;
+    void resetContents();
+
+    void updateVirtualRows();
+    void releaseVirtualRows();
+    void recycle(_<AView> view);
+    void recycleRow(Row& row);
+    Row acquire(Context& context, std::size_t index);
+
+    /**
+     * @brief Retargets an active row to the item at index.
+     */
+    void rebind(Context& context, Row& row, std::size_t index);
+    void watchScrollArea();
+    int rowHeight(std::size_t index) const noexcept;
+
+    /**
+     * @brief Offsets of rows after index are recomputed on the next ensureRowOffsets.
+     */
+    void invalidateRowOffsets(std::size_t index) noexcept;
+    void ensureRowOffsets();
+    std::size_t rowAt(int y) const noexcept;
 
-    emits<> notified;
+    /**
+     * @brief Vertical range of the rows container clipped by its ancestors, in the container's coordinates.
+     */
+    std::pair<int, int> visibleRange() const;
 };
@@ -15,6 +15,7 @@
 #include <LuaExposedView.h>
 #include <cfunction.hpp>
 #include <uiengine/UIEngine.h>
+#include <uiengine/LuaProfiler.h>
 
 template<typename Clazz>
 struct ViewExposer {
@@ -31,7 +32,7 @@ private:
                 if (!selfViewPtr) {
                     throw std::runtime_error(std::string("type mismatch: expected ") + typeid(Clazz).name() + ", got " + typeid(*self.get()).name());
                 }
-                (dynamic_cast<Clazz*>(selfViewPtr)->*m)(std::forward<Args>(args)...);
+                (selfViewPtr->*m)(std::forward<Args>(args)...);
 
                 return clg::builder_return_type{};
             };
@@ -45,11 +46,11 @@ private:
                 if (!selfViewPtr) {
                     throw std::runtime_error(std::string("type mismatch: expected ") + typeid(Clazz).name() + ", got " + typeid(*self.get()).name());
                 }
-                using return_t = decltype((dynamic_cast<Clazz*>(selfViewPtr)->*m)(std::forward<Args>(args)...));
+                using return_t = decltype((selfViewPtr->*m)(std::forward<Args>(args)...));
                 if constexpr (std::is_void_v<return_t>) {
-                    (dynamic_cast<Clazz*>(selfViewPtr)->*m)(std::forward<Args>(args)...);
+                    (selfViewPtr->*m)(std::forward<Args>(args)...);
                 } else {
-                    return (dynamic_cast<Clazz*>(selfViewPtr)->*m)(std::forward<Args>(args)...);
+                    return (selfViewPtr->*m)(std::forward<Args>(args)...);
                 }
             };
         }
@@ -85,7 +86,7 @@ public:
     template<typename Callback>
     ViewExposer& builder(std::string name, Callback&& callback) {
         using function_info = clg::state_interface::callable_class_info<decltype(&Callback::operator())>;
-        auto w = clg::state_interface(clg::state()).wrap_lambda_to_cfunction(make_the_builder(std::forward<Callback>(callback), function_info::args()), name);
+        auto w = clg::state_interface(mUiEngine.luaState()).wrap_lambda_to_cfunction(make_the_builder(std::forward<Callback>(callback), function_info::args()), name);
         mExtraMethods.push_back({std::move(name), w});
         return *this;
     }
@@ -99,7 +100,7 @@ public:
 
     template<typename Callback>
     ViewExposer& method(std::string name, Callback&& callback) {
-        auto w = clg::state_interface(clg::state()).wrap_lambda_to_cfunction(std::forward<Callback>(callback), name);
+        auto w = clg::state_interface(mUiEngine.luaState()).wrap_lambda_to_cfunction(std::forward<Callback>(callback), name);
         mExtraMethods.push_back({std::move(name), w});
         return *this;
     }
@@ -115,14 +116,19 @@ public:
     void ctor() {
         assert(("unnamed class could not have a constructor; use pushMetatable() instead", !mName.empty()));
         if (!mExtraMethods.empty()) {
-            lua_State* L = clg::state();
+            lua_State* L = mUiEngine.luaState();
             clg::stack_integrity_check check(L);
 
+            // methods are shared by all instances of the class: each data holder gets the same metatable with
+            // __index pointing to the method table, so fields assigned on an instance still shadow them.
             clg::impl::newlib(L, mExtraMethods);
-            auto indexForNewMT = clg::pop_from_lua<clg::table>(L);
+            LuaProfiler::nameBindings(L, mName);
+            lua_createtable(L, 0, 1);
+            lua_insert(L, -2);
+            lua_setfield(L, -2, "__index");
+            auto classMetatable = clg::ref::from_stack(L);
 
-
-            clg::state_interface(clg::state()).register_function(mName, [name = mName, &uiEngine = mUiEngine, indexForNewMT = std::move(indexForNewMT)](lua_State* lua, Args... args) {
+            clg::state_interface(mUiEngine.luaState()).register_function(mName, [name = mName, &uiEngine = mUiEngine, classMetatable = std::move(classMetatable)](lua_State* lua, Args... args) {
                 auto view = std::make_shared<LuaExposedView<Clazz>>(uiEngine, std::move(args)...);
                 view->addAssName(name);
 
@@ -130,23 +136,25 @@ public:
 
                 auto destination = view->luaDataHolder();
                 assert(!destination.isNull());
-                for (const auto& [k, v] : indexForNewMT) {
-                    destination[k] = v;
-                }
+                destination.push_value_to_stack(lua);
+                classMetatable.push_value_to_stack(lua);
+                lua_setmetatable(lua, -2);
+                lua_pop(lua, 1);
 
                 ref.push_value_to_stack(lua);
 
                 return fake{};
             });
-
+            nameConstructor();
             return;
         }
-        clg::state_interface(clg::state()).register_function(mName, [name = mName, &uiEngine = mUiEngine](Args... args) -> _<AView> {
+        clg::state_interface(mUiEngine.luaState()).register_function(mName, [name = mName, &uiEngine = mUiEngine](Args... args) -> _<AView> {
             auto view = std::make_shared<LuaExposedView<Clazz>>(uiEngine, std::move(args)...);
             view->addAssName(name);
 
             return view;
         });
+        nameConstructor();
     }
 
 private:
@@ -155,5 +163,12 @@ private:
 
     clg::lua_cfunctions mExtraMethods;
 
+    void nameConstructor() {
+        lua_State* L = mUiEngine.luaState();
+        lua_getglobal(L, mName.c_str());
+        LuaProfiler::nameBinding(L, mName);
+        lua_pop(L, 1);
+    }
+
     ViewExposer(UIEngine& uiEngine, std::string name = "") : mUiEngine(uiEngine), mName(std::move(name)) {}
 };
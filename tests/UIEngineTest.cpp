@@ -17,11 +17,20 @@
 #include "AUI/Test/UI/Action/MouseMove.h"
 #include "AUI/Test/UI/By.h"
 #include "uiengine/UIEngine.h"
+#include "uiengine/ILuaExposedView.h"
+#include "uiengine/LuaOverrideProfiler.h"
+#include "uiengine/LuaCanvas.h"
 #include "AUI/Test/UI/Assertion/Color.h"
 #include "AUI/View/AButton.h"
 #include "AUI/View/ATextField.h"
 #include "View/MyTextField.h"
 #include "View/MyScrollbar.h"
+#include <AUI/Thread/AThread.h>
+#include <chrono>
+#include <filesystem>
+#include <regex>
+#include <fstream>
+#include <thread>
 
 namespace {
 class TestWindow : public AWindow {
@@ -517,6 +526,93 @@ UI.setSurface(view)
     EXPECT_TRUE(mLua.global_variable("called").as<bool>()) << "not called";
 }
 
+TEST_F(UIEngineTest, CustomViewOverrideReset) {
+    test(R"(
+called = false
+
+view = Button('Gavno'):expanding():addStylesheetName(".target")
+
+function view:onPointerPressed()
+  called = true
+end
+
+view.onPointerPressed = nil
+
+UI.setSurface(view)
+)");
+    By::name(".target").perform(click());
+
+    EXPECT_FALSE(mLua.global_variable("called").as<bool>()) << "override was not reset";
+}
+
+TEST_F(UIEngineTest, PointerEventFields) {
+    test(R"(
+view = Button('Target'):expanding():addStylesheetName(".target")
+
+function view:onPointerPressed(event)
+  pressed = { x = event.position[1], finger = event.finger, unknown = event.unknown }
+end
+
+function view:onPointerReleased(event)
+  released = { triggerClick = event.triggerClick, x = event.position[1] }
+end
+
+UI.setSurface(view)
+)");
+    By::name(".target").perform(click());
+
+    EXPECT_TRUE(mLua.do_string<bool>("return type(pressed.x) == 'number'"));
+    EXPECT_TRUE(mLua.do_string<bool>("return pressed.unknown == nil"));
+    EXPECT_TRUE(mLua.do_string<bool>("return type(pressed.finger) == 'number'"));
+    EXPECT_TRUE(mLua.do_string<bool>("return released.triggerClick"));
+    EXPECT_TRUE(mLua.do_string<bool>("return released.x == pressed.x"));
+}
+
+TEST_F(UIEngineTest, PointerEventNestedDispatch) {
+    APointerPressedEvent inner;
+    inner.position = { 1.f, 2.f };
+    inner.pointerIndex = APointerIndex::button(AInput::LBUTTON);
+    inner.asButton = AInput::LBUTTON;
+    mLua.register_function("pressInner", [&](const _<AView>& view) {
+        view->onPointerPressed(inner);
+    });
+    test(R"(
+innerView = View()
+function innerView:onPointerPressed(event)
+  innerX = event.position[1]
+end
+
+view = Button('Target'):expanding():addStylesheetName(".target")
+function view:onPointerPressed(event)
+  before = event.position[1]
+  pressInner(innerView)
+  after = event.position[1]
+end
+
+UI.setSurface(Vertical { view, innerView })
+)");
+    By::name(".target").perform(click());
+
+    EXPECT_TRUE(mLua.do_string<bool>("return innerX == 1"));
+    EXPECT_TRUE(mLua.do_string<bool>("return before ~= nil and before == after"));
+}
+
+TEST_F(UIEngineTest, ClassMethodOverride) {
+    test(R"(
+a = Input('a')
+b = Input('b')
+
+function a:text()
+  return 'overridden'
+end
+
+assert(a:text() == 'overridden')
+assert(b:text() == 'b')
+b:setText('c')
+assert(b:text() == 'c')
+)");
+}
+
 TEST_F(UIEngineTest, RemoveView) {
     test(R"(
 v = View():setStyle({
@@ -1073,6 +1169,66 @@ UI.setSurface(root)
     By::name("abuduba").check(averageColor(AColor::GREEN));
 }
 
+TEST_F(UIEngineTest, SharedStyleTable) {
+    test(R"(
+local rowStyle = {
+  BackgroundSolid('#0f0'),
+  FixedSize(20),
+}
+local nestedStyle = {
+  shared = {
+    BackgroundSolid('#00f'),
+    FixedSize(20),
+  },
+}
+local rows = {}
+for i = 1, 10 do
+  rows[#rows + 1] = View():setStyle(rowStyle):addStylesheetName("row" .. i)
+  rows[#rows + 1] = Vertical { View():addStylesheetName("shared") }:setStyle(nestedStyle)
+end
+
+-- identical contents built separately share a compiled style with structural hashing
+UI.setStyleStructuralHashing(true)
+local red = BackgroundSolid('#f00')
+local size = FixedSize(20)
+for i = 1, 2 do
+  rows[#rows + 1] = View():setStyle({ red, size }):addStylesheetName("structural" .. i)
+end
+
+UI.setSurface(Vertical(rows))
+)");
+    By::name("row1").check(averageColor(AColor::GREEN));
+    By::name("row10").check(averageColor(AColor::GREEN));
+    By::name("structural1").check(averageColor(AColor::RED));
+    By::name("structural2").check(averageColor(AColor::RED));
+    for (const auto& v : By::name("shared").toSet()) {
+        EXPECT_EQ(v->getSize(), glm::ivec2(20));
+    }
+}
+
+TEST_F(UIEngineTest, StyleTableInvalidation) {
+    test(R"(
+style = { BackgroundSolid('#0f0'), FixedSize(20) }
+stale = View():setStyle(style):addStylesheetName("stale")
+fresh = View():addStylesheetName("fresh")
+UI.setSurface(Vertical { stale, fresh })
+
+-- compiled styles are cached by table identity: a modified table keeps its compiled style...
+style[1] = BackgroundSolid('#f00')
+fresh:setStyle(style)
+)");
+    By::name("stale").check(averageColor(AColor::GREEN));
+    By::name("fresh").check(averageColor(AColor::GREEN));
+
+    // ...until it is invalidated; views pick the new style up on their next setStyle
+    mLua.do_string(R"(
+UI.invalidateStyle(style)
+fresh:setStyle(style)
+)");
+    By::name("stale").check(averageColor(AColor::GREEN));
+    By::name("fresh").check(averageColor(AColor::RED));
+}
+
 TEST_F(UIEngineTest, Vec1) {
     mLua.register_function("test", [](glm::ivec2 v) { return v + 1; });
     mLua.do_string(R"(
@@ -1127,6 +1283,47 @@ assert(v[1][2] == 2)
     )");
 }
 
+TEST_F(UIEngineTest, VecUserdata) {
+    mLua.register_function("test", [](glm::ivec2 v) { return v * 2; });
+    mLua.register_function("testf", [](glm::vec3 v) { return v; });
+    mLua.do_string(R"(
+v = test(vec2(1, 2))
+assert(v.x == 2 and v.y == 4)
+assert(v[1] == 2 and v[2] == 4)
+assert(math.type(v.x) == 'integer')
+assert(#v == 2)
+assert(v == vec2(2, 4))
+assert(v + vec2(1, 1) == vec2(3, 5))
+assert(v - 1 == vec2(1, 3))
+assert(2 * v == vec2(4, 8))
+assert(-v == vec2(-2, -4))
+assert((v / 4).x == 0.5)
+assert(tostring(v) == 'vec2(2, 4)')
+
+-- tables are still accepted, vecs are accepted where tables were
+assert(test({3, 4}) == vec2(6, 8))
+assert(test(vec2(v)) == vec2(4, 8))
+
+v.x = 10
+assert(v.x == 10)
+
+f = testf(vec3(0.5, 1, 2))
+assert(f.z == 2 and f.x == 0.5)
+assert(math.type(f.y) == 'float')
+
+-- iterated like the tables vectors used to be
+local sum, count = 0, 0
+for i, c in pairs(vec3(1, 2, 3)) do sum = sum + i * c; count = count + 1 end
+assert(sum == 14 and count == 3)
+for i, c in ipairs(vec2(5, 6)) do count = count + c end
+assert(count == 14)
+
+-- integer // by zero fails as it does for integers; float vectors give inf
+assert(not pcall(function() return vec2(1, 2) // 0 end))
+assert((vec2(1.5, 2) // 0).x == math.huge)
+    )");
+}
+
 TEST_F(UIEngineTest, ParentTest) {
     mLua.register_function("expect_equal", [](const _<AView>& a, const _<AView>& b) { EXPECT_EQ(a, b); });
 
@@ -1385,6 +1582,31 @@ UI.setSurface(Centered { btn })
     By::text("Test").perform(click()).perform(click());
 }
 
+TEST_F(UIEngineTest, ClickedMultipleHandlers) {
+    test(R"(
+counts = { a = 0, b = 0, c = 0, late = 0 }
+btn = Button("Test")
+btn:clicked(function() counts.a = counts.a + 1 end)
+btn:clicked(function()
+  counts.b = counts.b + 1
+  btn:clicked(function() counts.late = counts.late + 1 end)
+  return SIGNAL_REMOVE
+end)
+btn:clicked(function() counts.c = counts.c + 1 end)
+UI.setSurface(Centered { btn })
+)");
+    By::text("Test").perform(click()).perform(click());
+    EXPECT_EQ(mLua.do_string<int>("return counts.a"), 2);
+    EXPECT_EQ(mLua.do_string<int>("return counts.b"), 1);
+    EXPECT_EQ(mLua.do_string<int>("return counts.c"), 2);
+    EXPECT_EQ(mLua.do_string<int>("return counts.late"), 1);
+
+    mLua.do_string("btn:dropClicked()");
+    By::text("Test").perform(click());
+    EXPECT_EQ(mLua.do_string<int>("return counts.a"), 2);
+    EXPECT_EQ(mLua.do_string<int>("return counts.late"), 1);
+}
+
 TEST_F(UIEngineTest, Merging1) {
     test(R"(
 UI.setSurface(Centered {
@@ -1469,3 +1691,711 @@ UI.setSurface(Centered { view })
     EXPECT_EQ(By::name("Test").one()->getContentMinimumWidth(), 228);
     EXPECT_TRUE(called);
 }
+
+TEST_F(UIEngineTest, LoadFormBytecodeCache) {
+    auto root = std::filesystem::temp_directory_path() / "aui.bindings.lua.test.forms";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+    auto writeForm = [&](std::string_view text) {
+        std::ofstream(root / "form.lua") << "return Label('" << text << "')";
+    };
+    auto cacheEntries = [&] {
+        std::size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(root / "cache")) {
+            count += entry.path().extension() == ".luac";
+        }
+        return count;
+    };
+
+    AViewContainer surface;
+    UIEngine uiEngine(surface);
+    uiEngine.setFormsRoot(root.string());
+    uiEngine.setBytecodeCacheDir((root / "cache").string());
+
+    writeForm("source");
+    auto label = _cast<ALabel>(uiEngine.loadForm("form.lua"));
+    ASSERT_NE(label, nullptr);
+    EXPECT_EQ(label->text(), "source");
+    EXPECT_EQ(cacheEntries(), 1);
+
+    // loaded from the cache
+    label = _cast<ALabel>(uiEngine.loadForm("form.lua"));
+    ASSERT_NE(label, nullptr);
+    EXPECT_EQ(label->text(), "source");
+
+    // stale cache entry is replaced
+    writeForm("edited");
+    label = _cast<ALabel>(uiEngine.loadForm("form.lua"));
+    ASSERT_NE(label, nullptr);
+    EXPECT_EQ(label->text(), "edited");
+    EXPECT_EQ(cacheEntries(), 1);
+
+    EXPECT_EQ(uiEngine.loadForm("missing.lua"), nullptr);
+
+    // paths that differ only in separators get their own entries
+    std::filesystem::create_directories(root / "a");
+    std::ofstream(root / "a" / "b.lua") << "return Label('a/b')";
+    std::ofstream(root / "a_b.lua") << "return Label('a_b')";
+    for (int i = 0; i < 2; ++i) {
+        label = _cast<ALabel>(uiEngine.loadForm("a/b.lua"));
+        ASSERT_NE(label, nullptr);
+        EXPECT_EQ(label->text(), "a/b");
+        label = _cast<ALabel>(uiEngine.loadForm("a_b.lua"));
+        ASSERT_NE(label, nullptr);
+        EXPECT_EQ(label->text(), "a_b");
+    }
+    EXPECT_EQ(cacheEntries(), 3);
+
+    // the entry of a deep form tree stays within the file name limit
+    std::filesystem::path deep;
+    for (int i = 0; i < 12; ++i) {
+        deep /= "nested_directory_with_a_long_name_" + std::to_string(i);
+    }
+    std::filesystem::create_directories(root / deep);
+    auto deepForm = deep / (std::string(100, 'f') + ".lua");
+    std::ofstream(root / deepForm) << "return Label('deep')";
+    for (int i = 0; i < 2; ++i) {
+        label = _cast<ALabel>(uiEngine.loadForm(deepForm.generic_string()));
+        ASSERT_NE(label, nullptr);
+        EXPECT_EQ(label->text(), "deep");
+    }
+    EXPECT_EQ(cacheEntries(), 4);
+    std::filesystem::remove_all(root);
+}
+
+TEST_F(UIEngineTest, EngineLuaState) {
+    AViewContainer surface;
+    UIEngine uiEngine(surface, clg::state());
+    EXPECT_EQ(uiEngine.luaState(), clg::state());
+
+    // views are bound to the engine that registered their constructor
+    auto view = mLua.do_string<_<AView>>("return Label('engine')");
+    auto luaView = ILuaExposedView::fromView(view.get());
+    ASSERT_NE(luaView, nullptr);
+    EXPECT_EQ(&luaView->uiEngine(), &uiEngine);
+}
+
+TEST_F(UIEngineTest, FromView) {
+    auto label = mLua.do_string<_<AView>>("return Label('exposed')");
+    auto luaLabel = ILuaExposedView::fromView(label.get());
+    ASSERT_NE(luaLabel, nullptr);
+    EXPECT_EQ(luaLabel->view(), label.get());
+    EXPECT_EQ(luaLabel->exposedAs<ALabel>(), label.get());
+    EXPECT_EQ(luaLabel->exposedAs<AButton>(), nullptr);
+
+    auto vertical = mLua.do_string<_<AView>>("return Vertical {}");
+    auto luaVertical = ILuaExposedView::fromView(vertical.get());
+    ASSERT_NE(luaVertical, nullptr);
+    EXPECT_EQ(luaVertical->view(), vertical.get());
+    EXPECT_NE(luaVertical->container(), nullptr);
+    EXPECT_EQ(luaVertical->exposedAs<ALabel>(), nullptr);
+
+    // views made on the C++ side are not exposed, including classes that have no exposed counterpart at all
+    EXPECT_EQ(ILuaExposedView::fromView(_new<ALabel>("plain").get()), nullptr);
+    EXPECT_EQ(ILuaExposedView::fromView(_new<AViewContainer>().get()), nullptr);
+    EXPECT_EQ(ILuaExposedView::fromView(nullptr), nullptr);
+}
+
+TEST_F(UIEngineTest, EnginesOnThreads) {
+    // an engine per thread, each with its own state
+    struct Result {
+        lua_State* state = nullptr;
+        bool boundToEngine = false;
+        bool signalRemoveInState = false;
+        AString text;
+        std::string error;
+    };
+    auto run = [](std::string text, Result& result) {
+        try {
+            clg::vm lua;
+            AViewContainer surface;
+            UIEngine engine(surface);
+            result.state = engine.luaState();
+            result.signalRemoveInState = lua.do_string<bool>("return type(SIGNAL_REMOVE) == 'table'");
+            for (int i = 0; i < 1000; ++i) {
+                auto view = lua.do_string<_<AView>>("return Label('" + text + "')");
+                auto luaView = ILuaExposedView::fromView(view.get());
+                result.boundToEngine = luaView != nullptr && &luaView->uiEngine() == &engine;
+                result.text = _cast<ALabel>(view)->text();
+                if (!result.boundToEngine) {
+                    break;
+                }
+            }
+        } catch (const std::exception& e) {
+            result.error = e.what();
+        }
+    };
+    Result first, second;
+    std::thread a(run, "first", std::ref(first));
+    std::thread b(run, "second", std::ref(second));
+    a.join();
+    b.join();
+
+    for (const auto* result : { &first, &second }) {
+        EXPECT_EQ(result->error, "");
+        EXPECT_TRUE(result->boundToEngine);
+        EXPECT_TRUE(result->signalRemoveInState);
+        EXPECT_NE(result->state, clg::state());
+    }
+    EXPECT_NE(first.state, second.state);
+    EXPECT_EQ(first.text, "first");
+    EXPECT_EQ(second.text, "second");
+}
+
+TEST_F(UIEngineTest, GcBudget) {
+    test(R"(
+UI.setSurface(Label('gc'))
+UI.setGcBudget(500)
+garbage = {}
+for i = 1, 100000 do garbage[i] = { i } end
+garbage = nil
+)");
+    for (int i = 0; i < 10; ++i) {
+        By::text("gc").one()->redraw();
+        uitest::frame();
+        AThread::processMessages();
+    }
+    EXPECT_GT(mLua.do_string<int>("return UI.gcStats().steps"), 0);
+    EXPECT_GE(mLua.do_string<int>("return UI.gcStats().maxPauseUs"), mLua.do_string<int>("return UI.gcStats().p99PauseUs"));
+    mLua.do_string("UI.setGcBudget(0)");
+}
+
+TEST_F(UIEngineTest, GcBudgetGenerational) {
+    test(R"(
+UI.setSurface(Label('gc'))
+UI.setGcBudget(500, true)
+garbage = {}
+for i = 1, 200000 do garbage[i] = { i } end
+peakKb = collectgarbage('count')
+garbage = nil
+)");
+    // each step is a single collection; past twice the live heap a full collection catches up
+    for (int i = 0; i < 10; ++i) {
+        By::text("gc").one()->redraw();
+        uitest::frame();
+        AThread::processMessages();
+    }
+    EXPECT_GT(mLua.do_string<int>("return UI.gcStats().steps"), 0);
+    EXPECT_GT(mLua.do_string<int>("return UI.gcStats().cycles"), 0);
+    EXPECT_LT(mLua.do_string<double>("return collectgarbage('count')"), mLua.do_string<double>("return peakKb / 2"));
+    mLua.do_string("UI.setGcBudget(0)");
+}
+
+TEST_F(UIEngineTest, OverrideProfiler) {
+    LuaOverrideProfiler::reset();
+    auto& counter = LuaOverrideProfiler::counter("Test\"View", "render");
+    counter.add(1500);
+    counter.add(500);
+    EXPECT_NE(LuaOverrideProfiler::toJson().find(R"({"class":"Test\"View","method":"render","calls":2,"totalNs":2000,"maxNs":1500})"),
+              std::string::npos);
+
+#if AUI_LUA_OVERRIDE_PROFILING
+    test(R"(
+view = Label('profiled')
+function view:render(ctx) end
+UI.setSurface(view)
+)");
+    uitest::frame();
+    EXPECT_GT(mLua.do_string<int>(R"(
+for _, entry in ipairs(UI.overrideProfile()) do
+  if entry.method == 'render' and entry.calls > 0 and entry.class ~= 'Test"View' then return entry.calls end
+end
+return 0
+)"), 0);
+#endif
+    LuaOverrideProfiler::reset();
+}
+
+TEST_F(UIEngineTest, Profiler) {
+    test(R"(
+function busy()
+  local x = 0
+  for i = 1, 2000000 do x = x + i % 7 end
+  return x
+end
+Profiler.start(100)
+UI.setSurface(Label('profiled'):setText(tostring(busy())))
+Profiler.stop()
+)");
+    EXPECT_GT(mLua.do_string<int>("return Profiler.sampleCount()"), 0);
+    auto folded = mLua.do_string<std::string>("return Profiler.folded()");
+    EXPECT_NE(folded.find("busy ("), std::string::npos);
+    // each line is "frame;frame;... count"
+    EXPECT_TRUE(std::regex_search(folded, std::regex(R"((^|\n)main chunk \([^\n]*;busy \([^\n]* \d+\n)")));
+    mLua.do_string("Profiler.reset()");
+    EXPECT_EQ(mLua.do_string<int>("return Profiler.sampleCount()"), 0);
+
+    // C frames of bindings are named after the class and the method
+    mLua.do_string(R"(
+Profiler.start(100)
+ForEachUI():setModel({ 1 }):setFactory(function(item)
+  busy()
+  return Label('row')
+end)
+Profiler.stop()
+)");
+    folded = mLua.do_string<std::string>("return Profiler.folded()");
+    EXPECT_TRUE(std::regex_search(folded, std::regex(R"(\[C\] ForEachUI:setFactory;[^\n]*busy \()")));
+
+    // a state has a single hook: a second profiler is refused while the first runs
+    LuaProfiler first(clg::state()), second(clg::state());
+    first.start();
+    EXPECT_THROW(second.start(), AException);
+    first.stop();
+    second.start();
+    second.stop();
+}
+
+TEST_F(UIEngineTest, Batch) {
+    test(R"(
+panel = Vertical {}
+UI.setSurface(panel)
+UI.batch(function()
+  for i = 1, 500 do panel:addView(Label('row ' .. i)) end
+  UI.batch(function()
+    panel:removeViewAtIndex(1)
+  end)
+  panel:addViewAtIndex(Label('first'), 0)
+end)
+)");
+    uitest::frame();
+    EXPECT_EQ(mLua.do_string<int>("return panel:size()"), 500);
+    auto first = By::text("first").one();
+    auto second = By::text("row 2").one();
+    EXPECT_LT(first->getPositionInWindow().y, second->getPositionInWindow().y);
+    EXPECT_TRUE(By::text("row 1").toSet().empty());
+
+    // errors end the batch as well
+    EXPECT_FALSE(mLua.do_string<bool>("return pcall(UI.batch, function() panel:addView(Label('failed')) error('oops') end)"));
+    mLua.do_string("panel:removeAllViews() panel:addView(Label('after'))");
+    uitest::frame();
+    EXPECT_FALSE(By::text("after").toSet().empty());
+
+    // the bindings' invalidations of a container are applied once, when the outermost batch ends
+    struct CountingContainer: AViewContainer {
+        int invalidations = 0;
+
+        void markMinContentSizeInvalid() override {
+            ++invalidations;
+            AViewContainer::markMinContentSizeInvalid();
+        }
+    };
+    auto counting = _new<CountingContainer>();
+    counting->setLayout(std::make_unique<AVerticalLayout>());
+    mLua.register_function("countingPanel", [&] { return _<AView>(counting); });
+    mLua.register_function("invalidations", [&] { return counting->invalidations; });
+    mLua.do_string(R"(
+local p = countingPanel()
+UI.batch(function()
+  for i = 1, 100 do p:addView(Label('row ' .. i)) end
+  UI.batch(function()
+    p:removeViewAtIndex(1)
+  end)
+  inBatch = invalidations()
+end)
+)");
+    EXPECT_EQ(counting->invalidations - mLua.do_string<int>("return inBatch"), 1);
+}
+
+TEST_F(UIEngineTest, BulkChildren) {
+    test(R"(
+panel = Vertical {}
+UI.setSurface(panel)
+local function labels(...)
+  local result = {}
+  for i, text in ipairs({...}) do result[i] = Label(text) end
+  return result
+end
+panel:addViews(labels('a', 'b', 'c', 'd'))
+panel:insertViews(2, labels('x', 'y'))
+panel:removeViews(4, 5)
+)");
+    auto texts = [&] {
+        AStringVector result;
+        for (const auto& view : _cast<AViewContainer>(mLua.do_string<_<AView>>("return panel"))->getViews()) {
+            result << _cast<ALabel>(view)->text();
+        }
+        return result;
+    };
+    EXPECT_EQ(texts(), (AStringVector{"a", "x", "y", "d"}));
+    mLua.do_string("panel:replaceChildren({ Label('z') })");
+    EXPECT_EQ(texts(), (AStringVector{"z"}));
+    EXPECT_FALSE(mLua.do_string<bool>("return pcall(panel.removeViews, panel, 1, 2)"));
+    EXPECT_FALSE(mLua.do_string<bool>("return pcall(panel.insertViews, panel, 3, {})"));
+    uitest::frame();
+    EXPECT_FALSE(By::text("z").toSet().empty());
+}
+
+TEST_F(UIEngineTest, ChildAnchors) {
+    test(R"(
+panel = Vertical {}
+UI.setSurface(panel)
+for i = 1, 4 do
+  local label = Label(tostring(i))
+  label.tag = 'child' .. i
+  panel:addView(label)
+end
+collectgarbage()
+)");
+    // fields of the children live in their data holders, which have to survive the collection
+    EXPECT_EQ(mLua.do_string<std::string>("return panel:getViews()[3].tag"), "child3");
+    mLua.do_string("panel:removeView(panel:getViews()[2]); panel:addView(Label('5')); collectgarbage()");
+    EXPECT_EQ(mLua.do_string<std::string>("return panel:getViews()[2].tag"), "child3");
+    auto panel = ILuaExposedView::fromView(mLua.do_string<_<AView>>("return panel").get());
+    ASSERT_NE(panel, nullptr);
+    EXPECT_EQ(panel->anchoredChildCount(), 4);
+    mLua.do_string("panel:removeAllViews()");
+    EXPECT_EQ(panel->anchoredChildCount(), 0);
+
+    // children passed to a container function are anchored as well
+    mLua.do_string("nested = Vertical { Label('x') }; nested:getViews()[1].tag = 'nested'; collectgarbage()");
+    EXPECT_EQ(mLua.do_string<std::string>("return nested:getViews()[1].tag"), "nested");
+    mLua.do_string("panel:addView(nested)");
+    uitest::frame();
+    AThread::processMessages();
+    mLua.do_string("collectgarbage()");
+    EXPECT_EQ(mLua.do_string<std::string>("return nested:getViews()[1].tag"), "nested");
+}
+
+TEST_F(UIEngineTest, HotReload) {
+    auto root = std::filesystem::temp_directory_path() / "aui.bindings.lua.test.hotreload";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+    std::ofstream(root / "form.lua") << "return Vertical { Label('a'), Input(''), Label('b'), Button('ok'):clicked(function() end) }";
+
+    AViewContainer surface;
+    UIEngine uiEngine(surface);
+    uiEngine.setFormsRoot(root.string());
+    uiEngine.setHotReload(true);
+    auto form = _cast<AViewContainer>(uiEngine.loadForm("form.lua"));
+    ASSERT_NE(form, nullptr);
+    surface.addView(form);
+    auto before = form->getViews();
+    _cast<MyTextField>(before[1])->setText("typed");
+
+    std::ofstream(root / "form.lua", std::ios::trunc) << "return Vertical { Label('a'), Input(''), Label('c'), Button('ok'):clicked(function() end) }";
+    ASSERT_TRUE(uiEngine.reloadForm("form.lua"));
+
+    ASSERT_EQ(surface.getViews().size(), 1);
+    EXPECT_EQ(surface.getViews().first(), form);
+    const auto& after = form->getViews();
+    ASSERT_EQ(after.size(), 4);
+    EXPECT_EQ(after[0], before[0]);
+    EXPECT_EQ(after[1], before[1]);
+    EXPECT_EQ(*_cast<MyTextField>(after[1])->text(), "typed");
+    EXPECT_NE(after[2], before[2]);
+    EXPECT_EQ(_cast<ALabel>(after[2])->text(), "c");
+    // handlers of the previous run are not kept
+    EXPECT_NE(after[3], before[3]);
+    EXPECT_FALSE(uiEngine.reloadForm("missing.lua"));
+}
+
+TEST_F(UIEngineTest, MinSizeMemoization) {
+    test(R"(
+calls = 0
+width = 40
+view = View():setMinSizeMemoization(true)
+function view:getContentMinimumWidth()
+  calls = calls + 1
+  return width
+end
+UI.setSurface(Horizontal { view })
+UI.resetMinSizeMemoStats()
+)");
+    auto view = mLua.do_string<_<AView>>("return view");
+    auto calls = [&] { return mLua.global_variable("calls").as<int>(); };
+    auto callsBefore = calls();
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(view->getContentMinimumWidth(), 40);
+    }
+    EXPECT_LE(calls() - callsBefore, 1);
+
+    // state the override depends on changed without the view knowing
+    mLua.do_string("width = 60; view:invalidate()");
+    EXPECT_EQ(view->getContentMinimumWidth(), 60);
+    EXPECT_EQ(view->getContentMinimumWidth(), 60);
+    EXPECT_LE(calls() - callsBefore, 2);
+
+    EXPECT_GT(mLua.do_string<double>("return UI.minSizeMemoStats().hitRate"), 0.0);
+    EXPECT_GT(mLua.do_string<int>("return UI.minSizeMemoStats().hits"), 0);
+}
+
+TEST_F(UIEngineTest, CanvasRetained) {
+    test(R"(
+draws = 0
+color = '#ff0000'
+view = View():expanding():addStylesheetName(".canvas"):setDraw(function(self, canvas)
+  draws = draws + 1
+  local w, h = self:getSize2()
+  canvas:rect(0, 0, w, h, color)
+  canvas:path({ 0, 0, w, h, 0, h }, '#000000', 1, true)
+end)
+UI.setSurface(view)
+)");
+    By::name(".canvas").check(averageColor(0xff0000_rgb));
+    auto draws = [&] { return mLua.global_variable("draws").as<int>(); };
+    auto recorded = draws();
+    EXPECT_GE(recorded, 1);
+    uitest::frame();
+    uitest::frame();
+    EXPECT_EQ(draws(), recorded) << "static frames must replay without calling Lua";
+
+    auto luaView = ILuaExposedView::fromView(mLua.do_string<_<AView>>("return view").get());
+    ASSERT_NE(luaView, nullptr);
+    ASSERT_NE(luaView->canvas(), nullptr);
+    EXPECT_EQ(luaView->canvas()->size(), 2);
+
+    mLua.do_string("color = '#0000ff'; view:invalidateDraw()");
+    By::name(".canvas").check(averageColor(0x0000ff_rgb));
+    EXPECT_EQ(draws(), recorded + 1);
+}
+
+TEST_F(UIEngineTest, StringConverters) {
+    test(R"(
+label = Label('привет, мир')
+button = Button('кнопка')
+)");
+    EXPECT_EQ(_cast<ALabel>(mLua.do_string<_<AView>>("return label"))->text(), "привет, мир");
+    EXPECT_EQ(AString(_cast<AAbstractLabel>(mLua.do_string<_<AView>>("return button"))->text()), "кнопка");
+    mLua.register_function("echo", [](const AString& s) { return s; });
+    EXPECT_EQ(mLua.do_string<std::string>("return echo('ünïcödé')"), "ünïcödé");
+    EXPECT_EQ(mLua.do_string<int>("return #echo('ab\\0cd')"), 5);
+    mLua.register_function("names", [] { return AStringVector{"one", "два"}; });
+    EXPECT_EQ(mLua.do_string<std::string>("local n = names() return n[1] .. n[2]"), "oneдва");
+    EXPECT_EQ(mLua.do_string<std::string>("return echo(42)"), "42");
+
+    // a number converted to a string must stay a number in its slot, otherwise lua_next can't go on from the key
+    lua_State* L = mLua;
+    lua_createtable(L, 0, 3);
+    for (int i = 1; i <= 3; ++i) {
+        lua_pushinteger(L, i * 10);
+        lua_pushboolean(L, true);
+        lua_settable(L, -3);
+    }
+    AString keys;
+    lua_pushnil(L);
+    while (lua_next(L, -2)) {
+        lua_pop(L, 1);
+        auto key = clg::get_from_lua_raw<AString>(L, -1);
+        EXPECT_FALSE(key.is_error());
+        keys += *key;
+        EXPECT_EQ(lua_type(L, -1), LUA_TNUMBER);
+    }
+    lua_pop(L, 1);
+    EXPECT_EQ(keys.length(), 6u);
+}
+
+TEST_F(UIEngineTest, LoadFormAsync) {
+    auto root = std::filesystem::temp_directory_path() / "aui.bindings.lua.test.async";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+    std::ofstream(root / "form.lua") << "return Label('async')";
+    std::ofstream(root / "broken.lua") << "return Label(";
+
+    AViewContainer surface;
+    UIEngine uiEngine(surface);
+    uiEngine.setFormsRoot(root.string());
+
+    auto wait = [](const bool& done) {
+        for (int i = 0; i < 1000 && !done; ++i) {
+            AThread::processMessages();
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    };
+
+    _<AView> view;
+    bool done = false;
+    uiEngine.loadFormAsync("form.lua", [&](_<AView> v) {
+        view = std::move(v);
+        done = true;
+    });
+    wait(done);
+    ASSERT_TRUE(done);
+    ASSERT_NE(_cast<ALabel>(view), nullptr);
+    EXPECT_EQ(_cast<ALabel>(view)->text(), "async");
+
+    done = false;
+    uiEngine.loadFormAsync("broken.lua", [&](_<AView> v) {
+        view = std::move(v);
+        done = true;
+    });
+    wait(done);
+    ASSERT_TRUE(done);
+    EXPECT_EQ(view, nullptr);
+
+    done = false;
+    uiEngine.runAsync("return Label('source')", "=source", [&](_<AView> v) {
+        view = std::move(v);
+        done = true;
+    });
+    wait(done);
+    ASSERT_TRUE(done);
+    EXPECT_EQ(_cast<ALabel>(view)->text(), "source");
+    std::filesystem::remove_all(root);
+}
+
+TEST_F(UIEngineTest, ForEachUIIncremental) {
+    test(R"(
+created = 0
+model = {}
+for i = 1, 5 do model[i] = { id = i, name = 'row ' .. i } end
+list = ForEachUI():setKey(function(item) return item.id end):setModel(model):setFactory(function(item)
+  created = created + 1
+  return Label(item.name)
+end)
+UI.setSurface(list)
+)");
+    auto names = [&] {
+        auto set = By::type<ALabel>().toSet();
+        std::vector<_<AView>> rows(set.begin(), set.end());
+        std::sort(rows.begin(), rows.end(), [](const _<AView>& a, const _<AView>& b) {
+            return a->getPositionInWindow().y < b->getPositionInWindow().y;
+        });
+        AStringVector result;
+        for (const auto& row : rows) {
+            result << _cast<ALabel>(row)->text();
+        }
+        return result;
+    };
+    auto created = [&] { return mLua.do_string<int>("return created"); };
+    EXPECT_EQ(created(), 5);
+
+    mLua.do_string("table.insert(model, 2, { id = 10, name = 'inserted' }) list:notifyInserted(2)");
+    uitest::frame();
+    EXPECT_EQ(created(), 6);
+    EXPECT_EQ(names(), (AStringVector{"row 1", "inserted", "row 2", "row 3", "row 4", "row 5"}));
+
+    mLua.do_string("table.remove(model, 3) list:notifyRemoved(3)");
+    mLua.do_string("table.insert(model, 1, table.remove(model, 5)) list:notifyMoved(5, 1)");
+    mLua.do_string("model[2] = { id = 1, name = 'changed' } list:notifyChanged(2)");
+    uitest::frame();
+    EXPECT_EQ(created(), 7);
+    EXPECT_EQ(names(), (AStringVector{"row 5", "changed", "inserted", "row 3", "row 4"}));
+
+    // keyed reconciliation: only the new item gets a view
+    mLua.do_string("model[#model + 1] = { id = 20, name = 'appended' } table.remove(model, 1) list:notify()");
+    uitest::frame();
+    EXPECT_EQ(created(), 8);
+    EXPECT_EQ(names(), (AStringVector{"changed", "inserted", "row 3", "row 4", "appended"}));
+}
+
+TEST_F(UIEngineTest, ForEachUIItemIdentity) {
+    test(R"(
+keyCalls = 0
+model = { { id = 1, name = 'first' } }
+list = ForEachUI():setModel(model):setFactory(function(item)
+  return Label(item.name)
+end)
+UI.setSurface(list)
+)");
+    // a replaced item must not be matched by the address of a collected one
+    for (int i = 0; i < 50; ++i) {
+        mLua.do_string("model[1] = { id = 1, name = 'item " + std::to_string(i) + "' } collectgarbage() list:notify()");
+        uitest::frame();
+        auto labels = By::type<ALabel>().toSet();
+        ASSERT_EQ(labels.size(), 1u);
+        EXPECT_EQ(_cast<ALabel>(*labels.begin())->text(), "item " + std::to_string(i));
+    }
+
+    // keys of already seen items are not computed again
+    mLua.do_string(R"(
+list:setKey(function(item)
+  keyCalls = keyCalls + 1
+  return item.id
+end)
+keyCalls = 0
+list:notify()
+)");
+    EXPECT_EQ(mLua.do_string<int>("return keyCalls"), 0);
+    mLua.do_string("model[#model + 1] = { id = 2, name = 'second' } list:notify()");
+    EXPECT_EQ(mLua.do_string<int>("return keyCalls"), 1);
+}
+
+TEST_F(UIEngineTest, ForEachUIVirtualized) {
+    test(R"(
+created = 0
+bound = 0
+model = {}
+for i = 1, 100000 do model[i] = 'row ' .. i end
+list = ForEachUI():setVirtualized(true):setRowHeight(20):setOverscan(0):setModel(model):setFactory(function(item)
+  created = created + 1
+  return Label(item)
+end):setBind(function(view, item)
+  bound = bound + 1
+  view:setText(item)
+end)
+area = ScrollArea():setContent(list)
+UI.setSurface(area)
+)");
+    uitest::frame();
+    uitest::frame();
+    auto labels = [] { return By::type<ALabel>().toSet().size(); };
+    auto created = [&] { return mLua.do_string<int>("return created"); };
+    EXPECT_GT(labels(), 0);
+    EXPECT_LT(labels(), 20);
+    EXPECT_EQ(created(), labels());
+
+    // scrolled out rows are rebound instead of being created
+    mLua.do_string("area:scroll({0, 100000})");
+    uitest::frame();
+    uitest::frame();
+    EXPECT_LT(labels(), 20);
+    EXPECT_LT(created(), 20);
+    EXPECT_GT(mLua.do_string<int>("return bound"), 0);
+    EXPECT_TRUE(By::text("row 1").toSet().empty());
+    EXPECT_FALSE(By::text("row 5001").toSet().empty());
+
+    // notify() rebinds only the rows whose items changed
+    auto bound = [&] { return mLua.do_string<int>("return bound"); };
+    auto boundBefore = bound();
+    auto createdBefore = created();
+    mLua.do_string("list:notify()");
+    EXPECT_EQ(bound(), boundBefore);
+    mLua.do_string("model[5001] = 'changed' list:notify()");
+    uitest::frame();
+    EXPECT_EQ(bound(), boundBefore + 1);
+    EXPECT_FALSE(By::text("changed").toSet().empty());
+
+    // without a bind function, views are made by the factory again
+    mLua.do_string("list:setBind(nil) model[5001] = 'again' list:notifyChanged(5001)");
+    uitest::frame();
+    EXPECT_EQ(bound(), boundBefore + 1);
+    EXPECT_EQ(created(), createdBefore + 1);
+    EXPECT_FALSE(By::text("again").toSet().empty());
+}
+
+TEST_F(UIEngineTest, ForEachUIVirtualizedStableScroll) {
+    test(R"(
+model = {}
+for i = 1, 1000 do model[i] = 'row ' .. i end
+list = ForEachUI():setVirtualized(true):setEstimatedRowHeight(20):setOverscan(0):setModel(model):setFactory(function(item)
+  local v = Label(item)
+  local n = tonumber(item:match('%d+')) or 0
+  v:setStyle({ FixedSize({}, n % 3 == 0 and 70 or 25) })
+  return v
+end)
+area = ScrollArea():setContent(list)
+UI.setSurface(area)
+)");
+    uitest::frame();
+    uitest::frame();
+    // scrolled step by step, so the rows above the visible area are measured
+    for (int i = 0; i < 20; ++i) {
+        mLua.do_string("area:scroll({0, 150})");
+        uitest::frame();
+    }
+    uitest::frame();
+    auto labels = By::type<ALabel>().toSet();
+    ASSERT_FALSE(labels.empty());
+    auto anchor = _cast<ALabel>(*labels.begin());
+    auto text = anchor->text();
+    auto y = anchor->getPositionInWindow().y;
+
+    // an append (as of a chat) keeps the heights of the rows above the visible area
+    mLua.do_string("model[#model + 1] = 'row 1001' list:notify()");
+    uitest::frame();
+    uitest::frame();
+    auto same = By::text(text).toSet();
+    ASSERT_EQ(same.size(), 1u);
+    EXPECT_EQ((*same.begin())->getPositionInWindow().y, y);
+}
@@ -299,3 +299,24 @@ TEST_F(UIStylesTest, TransformScale_2arg) {
     EXPECT_EQ(asTransformScale.scale.x, 1.0f);
     EXPECT_EQ(asTransformScale.scale.y, 2.0f);
 }
+
+TEST_F(UIStylesTest, Interning) {
+    using Property = std::shared_ptr<ass::prop::IPropertyBase>;
+    auto stats = mUiEngine.ruleInterningStats();
+
+    auto red1 = mLua.do_string<Property>("return BackgroundSolid('#f00')");
+    auto red2 = mLua.do_string<Property>("return BackgroundSolid('#ff0000')");
+    auto green = mLua.do_string<Property>("return BackgroundSolid('#0f0')");
+    EXPECT_EQ(red1, red2);
+    EXPECT_NE(red1, green);
+
+    auto padding1 = mLua.do_string<Property>("return Padding(4)");
+    auto padding2 = mLua.do_string<Property>("return Padding(4)");
+    auto padding3 = mLua.do_string<Property>("return Padding(4, 8)");
+    EXPECT_EQ(padding1, padding2);
+    EXPECT_NE(padding1, padding3);
+
+    EXPECT_EQ(mUiEngine.ruleInterningStats().hits - stats.hits, 2u);
+    EXPECT_EQ(mUiEngine.ruleInterningStats().misses - stats.misses, 4u);
+    EXPECT_EQ(mLua.do_string<std::size_t>("return UI.ruleInterningStats().hits"), mUiEngine.ruleInterningStats().hits);
+}